@@ -25,12 +25,17 @@
 #include <algorithm>
 #include <chrono>
 #include <cmath>
+#include <functional>
+#include <future>
 #include <list>
+#include <map>
 #include <memory>
 #include <optional>
 #include <shared_mutex>
 #include <thread>
 
+#include <boost/asio/post.hpp>
+#include <boost/asio/thread_pool.hpp>
 #include <boost/interprocess/streams/vectorstream.hpp>
 
 namespace koinos::chain {
@@ -38,27 +43,160 @@ namespace koinos::chain {
 using namespace std::string_literals;
 using namespace std::chrono_literals;
 
+namespace asio = boost::asio;
+
 using vectorstream = boost::interprocess::basic_vectorstream< std::vector< char > >;
 using fork_data    = std::pair< std::vector< block_topology >, block_topology >;
 
 namespace detail {
 
+/**
+ * Tracks the blocks linked to a trusted checkpoint.
+ *
+ * Block ids are linked from the checkpoint down, as reported by the ancestry of the checkpoint
+ * block. The expected id is remembered at anchor heights, and while indexing each anchor must be
+ * matched before the blocks below it are committed. Blocks in between are tied to the anchor above
+ * them by the previous ids in their headers.
+ */
+struct trusted_checkpoint
+{
+   static constexpr uint64_t anchor_interval = 1000;
+
+   trusted_checkpoint( uint64_t h, const crypto::multihash& i ) :
+      height( h ),
+      linked_height( h + 1 )
+   {
+      anchors.emplace( h, i );
+   }
+
+   uint64_t                                  height;
+   uint64_t                                  linked_height;
+   std::map< uint64_t, crypto::multihash >   anchors;
+   uint64_t                                  anchored_height = 0;
+};
+
+class block_submission_state final
+{
+   public:
+      block_submission_state( submission_callback callback ) : _callback( std::move( callback ) ) {}
+
+      block_submission submission()
+      {
+         block_submission submission;
+         submission.validated = _validated.get_future().share();
+         submission.applied   = _applied.get_future().share();
+         submission.committed = _committed.get_future().share();
+         submission.published = _published.get_future().share();
+         return submission;
+      }
+
+      // Completes the stage along with any earlier stage that has not completed yet
+      void complete( submission_stage stage )
+      {
+         while ( _next <= stage )
+         {
+            switch ( _next )
+            {
+               case submission_stage::validated:
+                  _validated.set_value();
+                  break;
+               case submission_stage::applied:
+                  _applied.set_value();
+                  break;
+               case submission_stage::committed:
+                  KOINOS_THROW( unexpected_state, "a committed submission requires a response" );
+               case submission_stage::published:
+                  _published.set_value();
+                  break;
+            }
+
+            notify();
+         }
+      }
+
+      void commit( rpc::chain::submit_block_response&& resp )
+      {
+         complete( submission_stage::applied );
+         _committed.set_value( std::move( resp ) );
+         notify();
+      }
+
+      void fail( std::exception_ptr e )
+      {
+         for ( ; _next <= submission_stage::published; _next = next_stage( _next ) )
+         {
+            switch ( _next )
+            {
+               case submission_stage::validated:
+                  _validated.set_exception( e );
+                  break;
+               case submission_stage::applied:
+                  _applied.set_exception( e );
+                  break;
+               case submission_stage::committed:
+                  _committed.set_exception( e );
+                  break;
+               case submission_stage::published:
+                  _published.set_exception( e );
+                  break;
+            }
+         }
+      }
+
+   private:
+      static submission_stage next_stage( submission_stage stage )
+      {
+         return submission_stage( std::underlying_type_t< submission_stage >( stage ) + 1 );
+      }
+
+      void notify()
+      {
+         auto stage = _next;
+         _next = next_stage( _next );
+
+         if ( _callback )
+            _callback( stage );
+      }
+
+      submission_callback                               _callback;
+      submission_stage                                  _next = submission_stage::validated;
+      std::promise< void >                              _validated;
+      std::promise< void >                              _applied;
+      std::promise< rpc::chain::submit_block_response > _committed;
+      std::promise< void >                              _published;
+};
+
 class controller_impl final
 {
    public:
-      controller_impl( uint64_t read_compute_bandwith_limit );
+      controller_impl( uint64_t read_compute_bandwith_limit, const std::string& vm_backend_name );
       ~controller_impl();
 
       void open( const std::filesystem::path& p, const genesis_data& data, bool reset );
       void set_client( std::shared_ptr< mq::client > c );
+      void set_trusted_checkpoint( uint64_t height, const crypto::multihash& id );
+      void link_trusted_block( uint64_t height, const crypto::multihash& id );
+      crypto::multicodec get_block_hash_code();
+      void set_module_cache_size( std::size_t bytes );
+      void set_hot_contracts( const std::vector< std::string >& contract_ids );
 
       rpc::chain::submit_block_response submit_block(
          const rpc::chain::submit_block_request&,
          uint64_t index_to,
-         std::chrono::system_clock::time_point now
+         std::chrono::system_clock::time_point now,
+         std::shared_ptr< const prevalidation_cache > prevalidation
+      );
+
+      block_submission async_submit_block(
+         const rpc::chain::submit_block_request&,
+         uint64_t index_to,
+         std::chrono::system_clock::time_point now,
+         std::shared_ptr< const prevalidation_cache > prevalidation,
+         submission_callback callback
       );
 
       rpc::chain::submit_transaction_response submit_transaction( const rpc::chain::submit_transaction_request& );
+      std::shared_future< rpc::chain::submit_transaction_response > async_submit_transaction( const rpc::chain::submit_transaction_request& );
       rpc::chain::get_head_info_response get_head_info( const rpc::chain::get_head_info_request& );
       rpc::chain::get_chain_id_response get_chain_id( const rpc::chain::get_chain_id_request& );
       rpc::chain::get_fork_heads_response get_fork_heads( const rpc::chain::get_fork_heads_request& );
@@ -73,7 +211,44 @@ class controller_impl final
       std::shared_ptr< vm_manager::vm_backend > _vm_backend;
       std::shared_ptr< mq::client >             _client;
       pending_state                             _pending_state;
+      std::shared_ptr< execution_context_cache_registry > _cache_registry = std::make_shared< execution_context_cache_registry >();
       uint64_t                                  _read_compute_bandwidth_limit;
+      std::optional< trusted_checkpoint >       _trusted_checkpoint;
+      std::optional< std::pair< state_db::state_node_id, std::shared_future< crypto::multihash > > > _pending_merkle_root;
+      asio::thread_pool                         _block_pool{ 1 };
+      asio::thread_pool                         _merkle_pool{ 1 };
+      asio::thread_pool                         _publish_pool{ 1 };
+      asio::thread_pool                         _prewarm_pool{ 1 };
+      asio::thread_pool                         _prefetch_pool{ 1 };
+      std::vector< std::string >                _hot_contracts;
+
+      rpc::chain::submit_block_response apply_block_submission(
+         const rpc::chain::submit_block_request&,
+         uint64_t index_to,
+         std::chrono::system_clock::time_point now,
+         std::shared_ptr< const prevalidation_cache > prevalidation,
+         std::function< void() >& publish,
+         std::optional< std::shared_future< crypto::multihash > >* merkle_root = nullptr
+      );
+
+      void finish_submission(
+         std::shared_ptr< block_submission_state > state,
+         rpc::chain::submit_block_response&& resp,
+         std::function< void() >&& publish
+      );
+
+      void wait_for_pending_merkle_root();
+
+      void prewarm_modules( const std::vector< std::pair< std::string, std::string > >& modules, bool pin = false );
+      void prewarm_hot_contracts( const abstract_state_node_ptr& head );
+      void prefetch_block( const protocol::block& block );
+
+      void publish_block(
+         const protocol::block& block,
+         const protocol::block_receipt& receipt,
+         const fork_data& forks,
+         const std::vector< event_bundle >& events
+      );
 
       void validate_block( const protocol::block& b );
       void validate_transaction( const protocol::transaction& t );
@@ -82,19 +257,26 @@ class controller_impl final
       fork_data get_fork_data_lockless();
 };
 
-controller_impl::controller_impl( uint64_t read_compute_bandwidth_limit ) : _read_compute_bandwidth_limit( read_compute_bandwidth_limit )
+controller_impl::controller_impl( uint64_t read_compute_bandwidth_limit, const std::string& vm_backend_name ) : _read_compute_bandwidth_limit( read_compute_bandwidth_limit )
 {
-   _vm_backend = vm_manager::get_vm_backend(); // Default is fizzy
-   KOINOS_ASSERT( _vm_backend, unknown_backend_exception, "could not get vm backend" );
+   _vm_backend = vm_manager::get_vm_backend( vm_backend_name );
+   KOINOS_ASSERT( _vm_backend, unknown_backend_exception, "could not get vm backend ${b}", ("b", vm_backend_name) );
 
    _vm_backend->initialize();
    LOG(info) << "Initialized " << _vm_backend->backend_name() << " vm backend";
 
    _pending_state.set_backend( _vm_backend );
+   _pending_state.set_cache_registry( _cache_registry );
 }
 
 controller_impl::~controller_impl()
 {
+   _block_pool.join();
+   _merkle_pool.join();
+   _publish_pool.join();
+   _prewarm_pool.join();
+   _prefetch_pool.join();
+
    std::lock_guard< std::shared_mutex > lock( _db_mutex );
    _db.close();
 }
@@ -141,9 +323,13 @@ void controller_impl::open( const std::filesystem::path& p, const chain::genesis
       _db.reset();
    }
 
+   _cache_registry->clear();
+
    auto head = _db.get_head();
    _pending_state.rebuild( head );
    LOG(info) << "Opened database at block - Height: " << head->revision() << ", ID: " << head->id();
+
+   prewarm_hot_contracts( head );
 }
 
 void controller_impl::set_client( std::shared_ptr< mq::client > c )
@@ -152,6 +338,169 @@ void controller_impl::set_client( std::shared_ptr< mq::client > c )
    _pending_state.set_client( c );
 }
 
+void controller_impl::set_trusted_checkpoint( uint64_t height, const crypto::multihash& id )
+{
+   std::lock_guard< std::shared_mutex > lock( _db_mutex );
+
+   _trusted_checkpoint.emplace( height, id );
+
+   LOG(warning) << "Trusted checkpoint enabled - Height: " << height << ", ID: " << id;
+   LOG(warning) << "Block signatures will not be verified while indexing blocks linked to the trusted checkpoint";
+}
+
+void controller_impl::link_trusted_block( uint64_t height, const crypto::multihash& id )
+{
+   std::lock_guard< std::shared_mutex > lock( _db_mutex );
+
+   KOINOS_ASSERT( _trusted_checkpoint, checkpoint_mismatch, "no trusted checkpoint is set" );
+
+   auto& checkpoint = *_trusted_checkpoint;
+
+   KOINOS_ASSERT(
+      height + 1 == checkpoint.linked_height,
+      unexpected_height,
+      "expected trusted block height of ${a}, was ${b}", ("a", checkpoint.linked_height - 1)("b", height)
+   );
+
+   if ( height == checkpoint.height || height % trusted_checkpoint::anchor_interval == 0 )
+   {
+      auto anchor = checkpoint.anchors.emplace( height, id ).first;
+
+      KOINOS_ASSERT(
+         anchor->second == id,
+         checkpoint_mismatch,
+         "block is not linked to the trusted checkpoint - height: ${h}, expected: ${e}, was: ${b}",
+         ("h", height)("e", util::to_hex( util::converter::as< std::string >( anchor->second ) ))("b", util::to_hex( util::converter::as< std::string >( id ) ))
+      );
+   }
+
+   checkpoint.linked_height = height;
+}
+
+crypto::multicodec controller_impl::get_block_hash_code()
+{
+   std::shared_lock< std::shared_mutex > lock( _db_mutex );
+   return _cache_registry->get( _db.get_head() )->block_hash_code;
+}
+
+void controller_impl::set_module_cache_size( std::size_t bytes )
+{
+   _vm_backend->set_module_cache_size( bytes );
+   LOG(info) << "Module cache size: " << bytes << " bytes";
+}
+
+void controller_impl::set_hot_contracts( const std::vector< std::string >& contract_ids )
+{
+   _hot_contracts = contract_ids;
+}
+
+void controller_impl::prewarm_modules( const std::vector< std::pair< std::string, std::string > >& modules, bool pin )
+{
+   if ( modules.empty() )
+      return;
+
+   // Parsing is off the critical path, a module that fails to parse fails again when it is called
+   asio::post( _prewarm_pool, [backend = _vm_backend, modules, pin]()
+   {
+      for ( const auto& [ id, bytecode ] : modules )
+      {
+         try
+         {
+            backend->prewarm( bytecode, id, pin );
+         }
+         catch ( const std::exception& e )
+         {
+            LOG(warning) << "Failed to prewarm contract module: " << e.what();
+         }
+      }
+   } );
+}
+
+void controller_impl::prewarm_hot_contracts( const abstract_state_node_ptr& head )
+{
+   std::vector< std::pair< std::string, std::string > > modules;
+
+   // System call overrides run on every block, they are always hot
+   for ( const auto& [ call_id, bundle ] : _cache_registry->get( head )->system_call )
+   {
+      const auto& [ contract_id, bytecode, entry_point, contract_meta ] = bundle;
+      modules.emplace_back( contract_meta.hash(), bytecode );
+   }
+
+   auto bytecodes = head->get_objects( state::space::contract_bytecode(), _hot_contracts );
+   auto metadatas = head->get_objects( state::space::contract_metadata(), _hot_contracts );
+
+   for ( std::size_t i = 0; i < _hot_contracts.size(); i++ )
+   {
+      if ( !bytecodes[ i ] || !metadatas[ i ] )
+      {
+         LOG(warning) << "Hot contract " << util::to_base58( _hot_contracts[ i ] ) << " does not exist";
+         continue;
+      }
+
+      modules.emplace_back( util::converter::to< contract_metadata_object >( *metadatas[ i ] ).hash(), std::move( *bytecodes[ i ] ) );
+   }
+
+   if ( modules.size() )
+      LOG(info) << "Prewarming " << modules.size() << " hot contract " << ( modules.size() == 1 ? "module" : "modules" );
+
+   prewarm_modules( modules, true );
+}
+
+void controller_impl::prefetch_block( const protocol::block& block )
+{
+   std::vector< std::pair< state_db::object_space, state_db::object_key > > objects;
+
+   // Predict the objects each transaction reads from its header and operations
+   for ( const auto& trx : block.transactions() )
+   {
+      const auto& payer = trx.header().payer();
+      const auto& payee = trx.header().payee();
+      bool use_payee = payee.size() && payee != payer;
+
+      objects.emplace_back( state::space::transaction_nonce(), use_payee ? payee : payer );
+      objects.emplace_back( state::space::contract_metadata(), payer );
+
+      if ( use_payee )
+         objects.emplace_back( state::space::contract_metadata(), payee );
+
+      for ( const auto& op : trx.operations() )
+      {
+         if ( op.has_call_contract() )
+         {
+            objects.emplace_back( state::space::contract_metadata(), op.call_contract().contract_id() );
+            objects.emplace_back( state::space::contract_bytecode(), op.call_contract().contract_id() );
+         }
+         else if ( op.has_upload_contract() )
+         {
+            objects.emplace_back( state::space::contract_metadata(), op.upload_contract().contract_id() );
+         }
+         else if ( op.has_set_system_call() && op.set_system_call().target().has_system_call_bundle() )
+         {
+            objects.emplace_back( state::space::contract_metadata(), op.set_system_call().target().system_call_bundle().contract_id() );
+            objects.emplace_back( state::space::contract_bytecode(), op.set_system_call().target().system_call_bundle().contract_id() );
+         }
+      }
+   }
+
+   if ( objects.empty() )
+      return;
+
+   // The reads happen while earlier blocks are applied, a failed prefetch only costs the cache warmth
+   asio::post( _prefetch_pool, [this, objects = std::move( objects ), height = block.header().height()]()
+   {
+      try
+      {
+         auto cached = _db.prefetch_objects( objects );
+         LOG(debug) << "Prefetched " << cached << " of " << objects.size() << " predicted objects for block at height " << height;
+      }
+      catch ( const std::exception& e )
+      {
+         LOG(warning) << "Failed to prefetch objects for block at height " << height << ": " << e.what();
+      }
+   } );
+}
+
 void controller_impl::validate_block( const protocol::block& b )
 {
    KOINOS_ASSERT( b.id().size(), missing_required_arguments, "missing expected field in block: ${field}", ("field", "id") );
@@ -179,7 +528,119 @@ void controller_impl::validate_transaction( const protocol::transaction& t )
 rpc::chain::submit_block_response controller_impl::submit_block(
    const rpc::chain::submit_block_request& request,
    uint64_t index_to,
-   std::chrono::system_clock::time_point now )
+   std::chrono::system_clock::time_point now,
+   std::shared_ptr< const prevalidation_cache > prevalidation )
+{
+   prefetch_block( request.block() );
+
+   std::function< void() > publish;
+   auto resp = apply_block_submission( request, index_to, now, prevalidation, publish );
+
+   if ( publish )
+      publish();
+
+   return resp;
+}
+
+block_submission controller_impl::async_submit_block(
+   const rpc::chain::submit_block_request& request,
+   uint64_t index_to,
+   std::chrono::system_clock::time_point now,
+   std::shared_ptr< const prevalidation_cache > prevalidation,
+   submission_callback callback )
+{
+   auto state = std::make_shared< block_submission_state >( std::move( callback ) );
+   auto submission = state->submission();
+
+   prefetch_block( request.block() );
+
+   asio::post( _block_pool, [this, state, request = std::make_shared< rpc::chain::submit_block_request >( request ), index_to, now, prevalidation]()
+   {
+      std::function< void() > publish;
+      std::optional< std::shared_future< crypto::multihash > > merkle_root;
+      rpc::chain::submit_block_response resp;
+
+      try
+      {
+         // While indexing, the state merkle root is computed while the next block is applied
+         resp = apply_block_submission( *request, index_to, now, prevalidation, publish, index_to ? &merkle_root : nullptr );
+      }
+      catch ( ... )
+      {
+         state->fail( std::current_exception() );
+         return;
+      }
+
+      // The block passed every check during application, and the stages are signalled once the
+      // database lock is released
+      state->complete( submission_stage::applied );
+
+      if ( !merkle_root )
+      {
+         finish_submission( state, std::move( resp ), std::move( publish ) );
+         return;
+      }
+
+      asio::post( _merkle_pool, [this, state, resp = std::move( resp ), publish = std::move( publish ), merkle_root = std::move( *merkle_root )]() mutable
+      {
+         try
+         {
+            resp.mutable_receipt()->set_state_merkle_root( util::converter::as< std::string >( merkle_root.get() ) );
+         }
+         catch ( ... )
+         {
+            state->fail( std::current_exception() );
+            return;
+         }
+
+         finish_submission( state, std::move( resp ), std::move( publish ) );
+      } );
+   } );
+
+   return submission;
+}
+
+void controller_impl::finish_submission(
+   std::shared_ptr< block_submission_state > state,
+   rpc::chain::submit_block_response&& resp,
+   std::function< void() >&& publish )
+{
+   state->commit( std::move( resp ) );
+
+   // Publishing happens on its own thread so the next block can be applied while this one is broadcast
+   asio::post( _publish_pool, [state, publish = std::move( publish )]()
+   {
+      try
+      {
+         if ( publish )
+            publish();
+      }
+      catch ( const std::exception& e )
+      {
+         LOG(error) << "Failed to publish block: " << e.what();
+      }
+
+      state->complete( submission_stage::published );
+   } );
+}
+
+void controller_impl::wait_for_pending_merkle_root()
+{
+   // Committing a node moves the state of its ancestors, which cannot happen while a root is computed
+   if ( _pending_merkle_root )
+   {
+      _pending_merkle_root->second.wait();
+      _pending_merkle_root.reset();
+   }
+}
+
+rpc::chain::submit_block_response controller_impl::apply_block_submission(
+   const rpc::chain::submit_block_request& request,
+   uint64_t index_to,
+   std::chrono::system_clock::time_point now,
+   std::shared_ptr< const prevalidation_cache > prevalidation,
+   std::function< void() >& publish,
+   std::optional< std::shared_future< crypto::multihash > >* merkle_root )
 {
    std::lock_guard< std::shared_mutex > lock( _db_mutex );
 
@@ -223,7 +684,7 @@ rpc::chain::submit_block_response controller_impl::submit_block(
       } );
 
       parent_ctx.set_state_node( parent_node );
-      parent_ctx.build_cache();
+      parent_ctx.set_cache( _cache_registry->get( parent_node ) );
       auto head_info = system_call::get_head_info( parent_ctx );
       parent_height = head_info.head_topology().height();
       time_lower_bound = head_info.head_block_time();
@@ -250,21 +711,68 @@ rpc::chain::submit_block_response controller_impl::submit_block(
       KOINOS_ASSERT( block.header().timestamp() <= time_upper_bound, timestamp_out_of_bounds, "block timestamp is too far in the future" );
       KOINOS_ASSERT( block.header().timestamp() >= time_lower_bound, timestamp_out_of_bounds, "block timestamp is too old" );
 
-      KOINOS_ASSERT(
-         block.header().previous_state_merkle_root() == util::converter::as< std::string >( parent_node->get_merkle_root() ),
-         state_merkle_mismatch,
-         "block previous state merkle mismatch"
-      );
+      // If the parent's merkle root is still being computed, the block is applied speculatively
+      // and the check is deferred until the root is ready
+      std::optional< std::shared_future< crypto::multihash > > parent_merkle_root;
+
+      if ( _pending_merkle_root && _pending_merkle_root->first == parent_id )
+         parent_merkle_root = _pending_merkle_root->second;
+      else
+         KOINOS_ASSERT(
+            block.header().previous_state_merkle_root() == util::converter::as< std::string >( parent_node->get_merkle_root() ),
+            state_merkle_mismatch,
+            "block previous state merkle mismatch"
+         );
+
+      // While indexing, blocks linked to a trusted checkpoint are verified by their hash linkage
+      // instead of by their signature. Until the next anchor above a trusted block is matched, the
+      // block is not known to be on the trusted chain.
+      bool trusted_block = false;
+
+      if ( index_to && _trusted_checkpoint && block_height <= _trusted_checkpoint->height )
+      {
+         trusted_block = block_height >= _trusted_checkpoint->linked_height;
+
+         if ( auto anchor = _trusted_checkpoint->anchors.find( block_height ); anchor != _trusted_checkpoint->anchors.end() )
+         {
+            KOINOS_ASSERT(
+               block_id == anchor->second,
+               checkpoint_mismatch,
+               "block does not match the trusted checkpoint - height: ${h}, expected: ${e}, was: ${b}",
+               ("h", block_height)("e", util::to_hex( util::converter::as< std::string >( anchor->second ) ))("b", util::to_hex( util::converter::as< std::string >( block_id ) ))
+            );
+
+            _trusted_checkpoint->anchored_height = block_height;
+         }
+
+         if ( block_height == _trusted_checkpoint->height )
+            LOG(info) << "Reached trusted checkpoint - Height: " << block_height << ", ID: " << block_id << ", resuming full validation";
+      }
 
       ctx.push_frame( stack_frame {
          .call_privilege = privilege::kernel_mode
       } );
 
       ctx.set_state_node( block_node );
-      ctx.build_cache();
+      ctx.set_prevalidation_cache( prevalidation );
+      ctx.set_trusted_block( trusted_block );
+      ctx.set_cache( _cache_registry->get( parent_node ) );
+
+      auto cache_start = _db.get_cache_stats();
 
       system_call::apply_block( ctx, block );
 
+      auto cache_end = _db.get_cache_stats();
+
+      if ( parent_merkle_root )
+      {
+         KOINOS_ASSERT(
+            block.header().previous_state_merkle_root() == util::converter::as< std::string >( parent_merkle_root->get() ),
+            state_merkle_mismatch,
+            "block previous state merkle mismatch"
+         );
+      }
+
       if ( _client && _client->is_running() )
       {
          rpc::block_store::block_store_request req;
@@ -292,84 +800,60 @@ rpc::chain::submit_block_response controller_impl::submit_block(
 
          LOG(info) << "Block application successful - Height: " << block_height << ", ID: " << block_id << " (" << num_transactions << ( num_transactions == 1 ? " transaction)" : " transactions)" );
          LOG(info) << "Consumed resources: " << disk_storage_used << " disk, " << network_bandwidth_used << " network, " << compute_bandwidth_used << " compute";
+
+         auto hits   = cache_end.hits - cache_start.hits;
+         auto misses = cache_end.misses - cache_start.misses;
+
+         if ( hits + misses )
+            LOG(info) << "Object cache: " << hits << " hits, " << misses << " misses (" << hits * 100.0 / ( hits + misses ) << "% hit rate)";
       }
       else if ( block_height % index_message_interval == 0 )
       {
          auto progress = block_height / static_cast< double >( index_to ) * 100;
          LOG(info) << "Indexing chain (" << progress << "%) - Height: " << block_height << ", ID: " << block_id;
+
+         if ( cache_end.hits + cache_end.misses )
+            LOG(info) << "Object cache hit rate: " << cache_end.hits * 100.0 / ( cache_end.hits + cache_end.misses ) << "%";
       }
 
       auto lib = system_call::get_last_irreversible_block( ctx );
 
+      // A trusted block past the last matched anchor could still be on a forged chain
+      if ( trusted_block )
+         lib = std::min( lib, _trusted_checkpoint->anchored_height );
+
       _db.finalize_node( block_node->id() );
 
+      if ( !ctx.cache_dirty() )
+         _cache_registry->inherit( block_node, parent_node );
+
+      prewarm_modules( ctx.uploaded_contracts() );
+
       if ( std::optional< state_node_ptr > node; lib > _db.get_root()->revision() )
       {
+         wait_for_pending_merkle_root();
          node = _db.get_node_at_revision( lib, block_node->id() );
          _db.commit_node( node.value()->id() );
       }
 
-      resp.mutable_receipt()->set_state_merkle_root( util::converter::as< std::string >( block_node->get_merkle_root() ) );
-
-      const auto [ fork_heads, last_irreversible_block ] = get_fork_data_lockless();
-
-      if ( _client && _client->is_running() )
+      if ( merkle_root )
       {
-         try
-         {
-            broadcast::block_irreversible bc;
-            bc.mutable_topology()->CopyFrom( last_irreversible_block );
-
-            _client->broadcast( "koinos.block.irreversible", util::converter::as< std::string >( bc ) );
-         }
-         catch ( const std::exception& e )
-         {
-            LOG(error) << "Failed to publish block irreversible to message broker: " << e.what();
-         }
-
-         try
-         {
-            broadcast::block_accepted ba;
-            *ba.mutable_block() = block;
-            *ba.mutable_receipt() = std::get< protocol::block_receipt >( ctx.receipt() );
-
-            _client->broadcast( "koinos.block.accept", util::converter::as< std::string >( ba ) );
-         }
-         catch ( const std::exception& e )
-         {
-            LOG(error) << "Failed to publish block application to message broker: " << e.what();
-         }
-
-         try
-         {
-            broadcast::fork_heads fh;
-            fh.mutable_last_irreversible_block()->CopyFrom( last_irreversible_block );
+         auto task = std::make_shared< std::packaged_task< crypto::multihash() > >( [block_node]() { return block_node->get_merkle_root(); } );
+         *merkle_root = task->get_future().share();
+         _pending_merkle_root = std::make_pair( block_node->id(), **merkle_root );
+         asio::post( _merkle_pool, [task]() { ( *task )(); } );
+      }
+      else
+      {
+         resp.mutable_receipt()->set_state_merkle_root( util::converter::as< std::string >( block_node->get_merkle_root() ) );
+      }
 
-            for ( const auto& fork_head : fork_heads )
-            {
-               auto* head = fh.add_heads();
-               *head = fork_head;
-            }
+      auto forks = get_fork_data_lockless();
 
-            _client->broadcast( "koinos.block.forks", util::converter::as< std::string >( fh ) );
-         }
-         catch ( const std::exception& e )
-         {
-            LOG(error) << "Failed to publish fork data to message broker: " << e.what();
-         }
-
-         try
-         {
-            for ( const auto& [ unused, event ] : ctx.chronicler().events() )
-            {
-               _client->broadcast( "koinos.event." + util::to_base58( event.source() ) + "." + event.name(), event.data() );
-            }
-         }
-         catch ( const std::exception& e )
-         {
-            LOG(error) << "Failed to publish block and transaction events to message broker: " << e.what();
-         }
-      }
+      publish = [this, block, receipt = std::get< protocol::block_receipt >( ctx.receipt() ), forks = std::move( forks ), events = ctx.chronicler().events()]()
+      {
+         publish_block( block, receipt, forks, events );
+      };
 
       try
       {
@@ -421,6 +905,85 @@ rpc::chain::submit_block_response controller_impl::submit_block(
    return resp;
 }
 
+void controller_impl::publish_block(
+   const protocol::block& block,
+   const protocol::block_receipt& receipt,
+   const fork_data& forks,
+   const std::vector< event_bundle >& events )
+{
+   const auto& [ fork_heads, last_irreversible_block ] = forks;
+
+   if ( _client && _client->is_running() )
+   {
+      try
+      {
+         broadcast::block_irreversible bc;
+         bc.mutable_topology()->CopyFrom( last_irreversible_block );
+
+         _client->broadcast( "koinos.block.irreversible", util::converter::as< std::string >( bc ) );
+      }
+      catch ( const std::exception& e )
+      {
+         LOG(error) << "Failed to publish block irreversible to message broker: " << e.what();
+      }
+
+      try
+      {
+         broadcast::block_accepted ba;
+         *ba.mutable_block() = block;
+         *ba.mutable_receipt() = receipt;
+
+         _client->broadcast( "koinos.block.accept", util::converter::as< std::string >( ba ) );
+      }
+      catch ( const std::exception& e )
+      {
+         LOG(error) << "Failed to publish block application to message broker: " << e.what();
+      }
+
+      try
+      {
+         broadcast::fork_heads fh;
+         fh.mutable_last_irreversible_block()->CopyFrom( last_irreversible_block );
+
+         for ( const auto& fork_head : fork_heads )
+         {
+            auto* head = fh.add_heads();
+            *head = fork_head;
+         }
+
+         _client->broadcast( "koinos.block.forks", util::converter::as< std::string >( fh ) );
+      }
+      catch ( const std::exception& e )
+      {
+         LOG(error) << "Failed to publish fork data to message broker: " << e.what();
+      }
+
+      try
+      {
+         for ( const auto& [ unused, event ] : events )
+         {
+            _client->broadcast( "koinos.event." + util::to_base58( event.source() ) + "." + event.name(), event.data() );
+         }
+      }
+      catch ( const std::exception& e )
+      {
+         LOG(error) << "Failed to publish block and transaction events to message broker: " << e.what();
+      }
+   }
+}
+
+std::shared_future< rpc::chain::submit_transaction_response > controller_impl::async_submit_transaction( const rpc::chain::submit_transaction_request& request )
+{
+   auto task = std::make_shared< std::packaged_task< rpc::chain::submit_transaction_response() > >(
+      [this, request]() { return submit_transaction( request ); }
+   );
+
+   auto future = task->get_future().share();
+   asio::post( _block_pool, [task]() { ( *task )(); } );
+
+   return future;
+}
+
 rpc::chain::submit_transaction_response controller_impl::submit_transaction( const rpc::chain::submit_transaction_request& request )
 {
    std::shared_lock< std::shared_mutex > lock( _db_mutex );
@@ -450,7 +1013,7 @@ rpc::chain::submit_transaction_response controller_impl::submit_transaction( con
    try
    {
       ctx.set_state_node( pending_trx_node );
-      ctx.build_cache();
+      ctx.set_cache( _pending_state.get_cache() );
 
       payer = transaction.header().payer();
 
@@ -462,6 +1025,11 @@ rpc::chain::submit_transaction_response controller_impl::submit_transaction( con
 
       system_call::apply_transaction( ctx, transaction );
 
+      if ( ctx.cache_dirty() )
+         _pending_state.mark_cache_dirty();
+
+      prewarm_modules( ctx.uploaded_contracts() );
+
       uint64_t disk_storage_used      = ctx.resource_meter().disk_storage_used();
       uint64_t network_bandwidth_used = ctx.resource_meter().network_bandwidth_used();
       uint64_t compute_bandwidth_used = ctx.resource_meter().compute_bandwidth_used();
@@ -530,7 +1098,7 @@ rpc::chain::get_head_info_response controller_impl::get_head_info( const rpc::ch
    } );
 
    ctx.set_state_node( _db.get_head() );
-   ctx.build_cache();
+   ctx.set_cache( _cache_registry->get( ctx.get_state_node() ) );
 
    auto head_info = system_call::get_head_info( ctx );
    block_topology topo = head_info.head_topology();
@@ -577,7 +1145,7 @@ fork_data controller_impl::get_fork_data_lockless()
    std::vector< state_db::state_node_ptr > fork_heads;
 
    ctx.set_state_node( _db.get_root() );
-   ctx.build_cache();
+   ctx.set_cache( _cache_registry->get( _db.get_root() ) );
    fork_heads = _db.get_fork_heads();
 
    auto head_info = system_call::get_head_info( ctx );
@@ -621,7 +1189,7 @@ rpc::chain::get_resource_limits_response controller_impl::get_resource_limits( c
    } );
 
    ctx.set_state_node( _db.get_head() );
-   ctx.build_cache();
+   ctx.set_cache( _cache_registry->get( ctx.get_state_node() ) );
 
    auto value = system_call::get_resource_limits( ctx );
 
@@ -643,7 +1211,7 @@ rpc::chain::get_account_rc_response controller_impl::get_account_rc( const rpc::
    } );
 
    ctx.set_state_node( _db.get_head() );
-   ctx.build_cache();
+   ctx.set_cache( _cache_registry->get( ctx.get_state_node() ) );
 
    auto value = system_call::get_account_rc( ctx, request.account() );
 
@@ -682,7 +1250,7 @@ rpc::chain::read_contract_response controller_impl::read_contract( const rpc::ch
    } );
 
    ctx.set_state_node( _db.get_head() );
-   ctx.build_cache();
+   ctx.set_cache( _cache_registry->get( ctx.get_state_node() ) );
 
    resource_limit_data rl;
    rl.set_compute_bandwidth_limit( _read_compute_bandwidth_limit );
@@ -712,7 +1280,7 @@ rpc::chain::get_account_nonce_response controller_impl::get_account_nonce( const
    } );
 
    ctx.set_state_node( _db.get_head() );
-   ctx.build_cache();
+   ctx.set_cache( _cache_registry->get( ctx.get_state_node() ) );
 
    auto nonce = system_call::get_account_nonce( ctx, request.account() );
 
@@ -724,7 +1292,7 @@ rpc::chain::get_account_nonce_response controller_impl::get_account_nonce( const
 
 } // detail
 
-controller::controller( uint64_t read_compute_bandwith_limit ) : _my( std::make_unique< detail::controller_impl >( read_compute_bandwith_limit ) ) {}
+controller::controller( uint64_t read_compute_bandwith_limit, const std::string& vm_backend_name ) : _my( std::make_unique< detail::controller_impl >( read_compute_bandwith_limit, vm_backend_name ) ) {}
 
 controller::~controller() = default;
 
@@ -738,12 +1306,38 @@ void controller::set_client( std::shared_ptr< mq::client > c )
    _my->set_client( c );
 }
 
+void controller::set_trusted_checkpoint( uint64_t height, const crypto::multihash& id )
+{
+   _my->set_trusted_checkpoint( height, id );
+}
+
+void controller::link_trusted_block( uint64_t height, const crypto::multihash& id )
+{
+   _my->link_trusted_block( height, id );
+}
+
+crypto::multicodec controller::get_block_hash_code()
+{
+   return _my->get_block_hash_code();
+}
+
+void controller::set_module_cache_size( std::size_t bytes )
+{
+   _my->set_module_cache_size( bytes );
+}
+
+void controller::set_hot_contracts( const std::vector< std::string >& contract_ids )
+{
+   _my->set_hot_contracts( contract_ids );
+}
+
 rpc::chain::submit_block_response controller::submit_block(
    const rpc::chain::submit_block_request& request,
    uint64_t index_to,
-   std::chrono::system_clock::time_point now )
+   std::chrono::system_clock::time_point now,
+   std::shared_ptr< const prevalidation_cache > prevalidation )
 {
-   return _my->submit_block( request, index_to, now );
+   return _my->submit_block( request, index_to, now, prevalidation );
 }
 
 rpc::chain::submit_transaction_response controller::submit_transaction( const rpc::chain::submit_transaction_request& request )
@@ -751,6 +1345,21 @@ rpc::chain::submit_transaction_response controller::submit_transaction( const rp
    return _my->submit_transaction( request );
 }
 
+block_submission controller::async_submit_block(
+   const rpc::chain::submit_block_request& request,
+   uint64_t index_to,
+   std::chrono::system_clock::time_point now,
+   std::shared_ptr< const prevalidation_cache > prevalidation,
+   submission_callback callback )
+{
+   return _my->async_submit_block( request, index_to, now, prevalidation, std::move( callback ) );
+}
+
+std::shared_future< rpc::chain::submit_transaction_response > controller::async_submit_transaction( const rpc::chain::submit_transaction_request& request )
+{
+   return _my->async_submit_transaction( request );
+}
+
 rpc::chain::get_head_info_response controller::get_head_info( const rpc::chain::get_head_info_request& request )
 {
    return _my->get_head_info( request );
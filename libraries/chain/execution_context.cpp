@@ -3,6 +3,8 @@
 #include <koinos/chain/types.hpp>
 #include <koinos/chain/execution_context.hpp>
 
+#include <algorithm>
+
 namespace koinos::chain {
 
 namespace constants {
@@ -12,6 +14,7 @@ namespace constants {
 execution_context::execution_context( std::shared_ptr< vm_manager::vm_backend > vm_backend, chain::intent i ) :
    _vm_backend( vm_backend )
 {
+   _stack.reserve( stack_limit );
    set_intent( i );
 }
 
@@ -79,7 +82,37 @@ void execution_context::clear_transaction()
    _trx = nullptr;
 }
 
-const std::string& execution_context::get_contract_call_args() const
+void execution_context::set_prepared_transaction( const prepared_transaction* trx )
+{
+   _prepared_trx = trx;
+}
+
+const prepared_transaction* execution_context::get_prepared_transaction() const
+{
+   return _prepared_trx;
+}
+
+void execution_context::set_prevalidation_cache( std::shared_ptr< const chain::prevalidation_cache > cache )
+{
+   _prevalidation_cache = cache;
+}
+
+const chain::prevalidation_cache* execution_context::get_prevalidation_cache() const
+{
+   return _prevalidation_cache.get();
+}
+
+void execution_context::set_trusted_block( bool trusted )
+{
+   _trusted_block = trusted;
+}
+
+bool execution_context::trusted_block() const
+{
+   return _trusted_block;
+}
+
+std::string_view execution_context::get_contract_call_args() const
 {
    KOINOS_ASSERT( _stack.size() > 1, stack_exception, "stack is empty" );
    return _stack[ _stack.size() - 2 ].call_args;
@@ -88,7 +121,8 @@ const std::string& execution_context::get_contract_call_args() const
 std::string execution_context::get_contract_return() const
 {
    KOINOS_ASSERT( _stack.size() > 1, stack_exception, "stack is empty" );
-   return _stack[ _stack.size() - 2 ].call_return;
+   const auto* ret = _stack[ _stack.size() - 2 ].call_return;
+   return ret ? *ret : std::string();
 }
 
 uint32_t execution_context::get_contract_entry_point() const
@@ -100,7 +134,25 @@ uint32_t execution_context::get_contract_entry_point() const
 void execution_context::set_contract_return( const std::string& ret )
 {
    KOINOS_ASSERT( _stack.size() > 1, stack_exception, "stack is empty" );
-   _stack[ _stack.size() - 2 ].call_return = ret;
+
+   // Frames pushed outside of a contract call have no one to return to
+   if ( auto* buffer = _stack[ _stack.size() - 2 ].call_return; buffer )
+      *buffer = ret;
+}
+
+void execution_context::request_exit()
+{
+   _exit_requested = true;
+}
+
+bool execution_context::exit_requested() const
+{
+   return _exit_requested;
+}
+
+void execution_context::clear_exit()
+{
+   _exit_requested = false;
 }
 
 void execution_context::set_key_authority( const crypto::public_key& key )
@@ -122,23 +174,23 @@ void execution_context::push_frame( stack_frame&& frame )
 stack_frame execution_context::pop_frame()
 {
    KOINOS_ASSERT( _stack.size(), stack_exception, "stack is empty" );
-   auto frame = _stack[ _stack.size() - 1 ];
+   auto frame = std::move( _stack.back() );
    _stack.pop_back();
    return frame;
 }
 
-const std::string& execution_context::get_caller() const
+const std::string& execution_context::get_caller( std::size_t depth ) const
 {
-   if ( _stack.size() > 1 )
-      return _stack[ _stack.size() - 2 ].contract_id;
+   if ( _stack.size() > depth + 1 )
+      return _stack[ _stack.size() - depth - 2 ].contract_id;
 
    return constants::system;
 }
 
-privilege execution_context::get_caller_privilege() const
+privilege execution_context::get_caller_privilege( std::size_t depth ) const
 {
-   if ( _stack.size() > 1 )
-      return _stack[ _stack.size() - 2 ].call_privilege;
+   if ( _stack.size() > depth + 1 )
+      return _stack[ _stack.size() - depth - 2 ].call_privilege;
 
    return privilege::kernel_mode;
 }
@@ -179,6 +231,41 @@ bool execution_context::read_only() const
    return _intent == intent::read_only;
 }
 
+std::shared_ptr< const google::protobuf::Message > execution_context::get_decoded_object( uint32_t space_id, const std::string& key ) const
+{
+   if ( !_current_state_node )
+      return nullptr;
+
+   auto space_iter = _decoded_objects.find( space_id );
+   if ( space_iter == _decoded_objects.end() )
+      return nullptr;
+
+   auto iter = space_iter->second.find( key );
+   if ( iter == space_iter->second.end() )
+      return nullptr;
+
+   const auto& node = iter->second.node;
+   if ( node == _current_state_node )
+      return iter->second.object;
+
+   // Anything written in an anonymous child evicts the object, so the parent's value is still current
+   if ( auto anonymous_node = std::dynamic_pointer_cast< state_db::anonymous_state_node >( _current_state_node ); anonymous_node && anonymous_node->get_parent() == node )
+      return iter->second.object;
+
+   return nullptr;
+}
+
+void execution_context::set_decoded_object( uint32_t space_id, const std::string& key, std::shared_ptr< const google::protobuf::Message > object )
+{
+   _decoded_objects[ space_id ][ key ] = decoded_object{ _current_state_node, std::move( object ) };
+}
+
+void execution_context::evict_decoded_object( uint32_t space_id, const std::string& key )
+{
+   if ( auto space_iter = _decoded_objects.find( space_id ); space_iter != _decoded_objects.end() )
+      space_iter->second.erase( key );
+}
+
 resource_meter& execution_context::resource_meter()
 {
    return _resource_meter;
@@ -212,37 +299,42 @@ chain::intent execution_context::intent() const
    return _intent;
 }
 
-void execution_context::build_compute_registry_cache()
+execution_context_cache::execution_context_cache( const abstract_state_node& node )
 {
-   auto obj = _current_state_node->get_object( state::space::metadata(), state::key::compute_bandwidth_registry );
-   KOINOS_ASSERT( obj, unexpected_state, "compute bandwidth registry does not exist" );
-   auto compute_registry = util::converter::to< compute_bandwidth_registry >( *obj );
+   build_compute_registry_cache( node );
+   build_system_call_cache( node );
+   build_block_hash_code_cache( node );
 
-   _cache.compute_bandwidth.clear();
-   for ( const auto& entry : compute_registry.entries() )
-      _cache.compute_bandwidth[ entry.name() ] = entry.compute();
+   auto pdesc = node.get_object( state::space::metadata(), state::key::protocol_descriptor );
+   KOINOS_ASSERT( pdesc, unexpected_state, "file descriptor set does not exist" );
+   _protocol_descriptor = *pdesc;
 }
 
-void execution_context::build_descriptor_pool()
+void execution_context_cache::build_compute_registry_cache( const abstract_state_node& node )
 {
-   auto pdesc = _current_state_node->get_object( state::space::metadata(), state::key::protocol_descriptor );
-   KOINOS_ASSERT( pdesc, unexpected_state, "file descriptor set does not exist" );
+   auto obj = node.get_object( state::space::metadata(), state::key::compute_bandwidth_registry );
+   KOINOS_ASSERT( obj, unexpected_state, "compute bandwidth registry does not exist" );
+   auto compute_registry = util::converter::to< compute_bandwidth_registry >( *obj );
 
-   google::protobuf::FileDescriptorSet fdesc;
-   KOINOS_ASSERT( fdesc.ParseFromString( *pdesc ), unexpected_state, "file descriptor set is malformed" );
+   auto desc = chain::system_call_id_descriptor();
 
-   _cache.descriptor_pool = std::make_unique< google::protobuf::DescriptorPool >();
-   for ( const auto& fd : fdesc.file() )
-      _cache.descriptor_pool->BuildFile( fd );
+   compute_bandwidth.fill( std::nullopt );
+   for ( const auto& entry : compute_registry.entries() )
+   {
+      auto enum_value = desc->FindValueByName( entry.name() );
+      if ( enum_value && enum_value->number() >= 0 && std::size_t( enum_value->number() ) < compute_bandwidth.size() )
+         compute_bandwidth[ enum_value->number() ] = entry.compute();
+   }
 }
 
-void execution_context::build_system_call_cache()
+void execution_context_cache::build_system_call_cache( const abstract_state_node& node )
 {
-   _cache.system_call.clear();
+   std::vector< std::pair< uint32_t, protocol::system_call_bundle > > bundles;
+
    state_db::object_key next = std::string{};
    for (;;)
    {
-      auto obj = _current_state_node->get_next_object( state::space::system_call_dispatch(), next );
+      auto obj = node.get_next_object( state::space::system_call_dispatch(), next );
       if ( obj.first == nullptr )
          break;
 
@@ -253,103 +345,225 @@ void execution_context::build_system_call_cache()
       auto call_id = util::converter::to< uint32_t >( obj.second );
       if ( system_call_target.has_system_call_bundle() )
       {
-         auto contract_id       = system_call_target.system_call_bundle().contract_id();
-         auto entry_point       = system_call_target.system_call_bundle().entry_point();
-         auto contract_meta     = _current_state_node->get_object( state::space::contract_metadata(), util::converter::as< std::string >( contract_id ) );
-         auto contract_bytecode = _current_state_node->get_object( state::space::contract_bytecode(), util::converter::as< std::string >( contract_id ) );
-
-         KOINOS_ASSERT( contract_meta, unexpected_state, "contract metadata for call id ${id} not found", ("id", call_id) );
-         KOINOS_ASSERT( contract_bytecode, unexpected_state, "contract bytecode for call id ${id} not found", ("id", call_id) );
-
-         _cache.system_call[ call_id ] = std::make_tuple( contract_id, *contract_bytecode, entry_point, util::converter::to< chain::contract_metadata_object >( *contract_meta ) );
+         bundles.emplace_back( call_id, system_call_target.system_call_bundle() );
       }
       else
       {
          KOINOS_ASSERT( system_call_target.has_thunk_id(), unexpected_state, "expected thunk id for call id ${id}", ("id", call_id) );
-         _cache.thunk[ call_id ] = system_call_target.thunk_id();
+         thunk[ call_id ] = system_call_target.thunk_id();
       }
    }
+
+   if ( bundles.empty() )
+      return;
+
+   // The override contracts are read in two batches rather than two reads per override
+   std::vector< state_db::object_key > contract_ids;
+   contract_ids.reserve( bundles.size() );
+
+   for ( const auto& [ call_id, bundle ] : bundles )
+      contract_ids.emplace_back( util::converter::as< std::string >( bundle.contract_id() ) );
+
+   auto contract_metas     = node.get_objects( state::space::contract_metadata(), contract_ids );
+   auto contract_bytecodes = node.get_objects( state::space::contract_bytecode(), contract_ids );
+
+   for ( std::size_t i = 0; i < bundles.size(); i++ )
+   {
+      const auto& [ call_id, bundle ] = bundles[ i ];
+
+      KOINOS_ASSERT( contract_metas[ i ], unexpected_state, "contract metadata for call id ${id} not found", ("id", call_id) );
+      KOINOS_ASSERT( contract_bytecodes[ i ], unexpected_state, "contract bytecode for call id ${id} not found", ("id", call_id) );
+
+      system_call[ call_id ] = std::make_tuple( bundle.contract_id(), std::move( *contract_bytecodes[ i ] ), bundle.entry_point(), util::converter::to< chain::contract_metadata_object >( *contract_metas[ i ] ) );
+   }
 }
 
-void execution_context::build_block_hash_code_cache()
+void execution_context_cache::build_block_hash_code_cache( const abstract_state_node& node )
 {
-   auto bhash = _current_state_node->get_object( state::space::metadata(), state::key::block_hash_code );
+   auto bhash = node.get_object( state::space::metadata(), state::key::block_hash_code );
    KOINOS_ASSERT( bhash, unexpected_state, "block hash code does not exist" );
 
-   _cache.block_hash_code.emplace( crypto::multicodec( util::converter::to< unsigned_varint >( *bhash ).value ) );
+   block_hash_code = crypto::multicodec( util::converter::to< unsigned_varint >( *bhash ).value );
+}
+
+const google::protobuf::DescriptorPool& execution_context_cache::descriptor_pool() const
+{
+   std::call_once( _descriptor_pool_flag, [&]()
+   {
+      google::protobuf::FileDescriptorSet fdesc;
+      KOINOS_ASSERT( fdesc.ParseFromString( _protocol_descriptor ), unexpected_state, "file descriptor set is malformed" );
+
+      auto pool = std::make_unique< google::protobuf::DescriptorPool >();
+      for ( const auto& fd : fdesc.file() )
+         pool->BuildFile( fd );
+
+      _descriptor_pool = std::move( pool );
+   } );
+
+   return *_descriptor_pool;
+}
+
+std::shared_ptr< const execution_context_cache > execution_context_cache_registry::get( const abstract_state_node_ptr& node )
+{
+   KOINOS_ASSERT( node, unexpected_state, "cannot build execution context cache without a state node" );
+
+   {
+      std::lock_guard< std::mutex > lock( _mutex );
+      if ( auto iter = _caches.find( node->id() ); iter != _caches.end() )
+         return iter->second.second;
+   }
+
+   auto cache = std::make_shared< const execution_context_cache >( *node );
+   insert( node, cache );
+   return cache;
+}
+
+void execution_context_cache_registry::inherit( const abstract_state_node_ptr& node, const abstract_state_node_ptr& parent )
+{
+   std::shared_ptr< const execution_context_cache > cache;
+
+   {
+      std::lock_guard< std::mutex > lock( _mutex );
+      if ( auto iter = _caches.find( parent->id() ); iter != _caches.end() )
+         cache = iter->second.second;
+   }
+
+   if ( cache )
+      insert( node, std::move( cache ) );
+}
+
+void execution_context_cache_registry::clear()
+{
+   std::lock_guard< std::mutex > lock( _mutex );
+   _caches.clear();
+}
+
+void execution_context_cache_registry::insert( const abstract_state_node_ptr& node, std::shared_ptr< const execution_context_cache > cache )
+{
+   std::lock_guard< std::mutex > lock( _mutex );
+   _caches[ node->id() ] = std::make_pair( node->revision(), std::move( cache ) );
+
+   // Evict the oldest entries, they belong to nodes that are irreversible or on dead forks
+   while ( _caches.size() > max_entries )
+   {
+      auto oldest = std::min_element( _caches.begin(), _caches.end(), []( const auto& a, const auto& b )
+      {
+         return a.second.first < b.second.first;
+      } );
+      _caches.erase( oldest );
+   }
 }
 
 void execution_context::build_cache()
 {
    KOINOS_ASSERT( _current_state_node, unexpected_state, "cannot rebuild execution context cache without a state node" );
+   _cache = std::make_shared< const execution_context_cache >( *_current_state_node );
+}
 
-   build_compute_registry_cache();
-   build_descriptor_pool();
-   build_system_call_cache();
-   build_block_hash_code_cache();
+void execution_context::set_cache( std::shared_ptr< const execution_context_cache > cache )
+{
+   _cache = cache;
 }
 
-uint64_t execution_context::get_compute_bandwidth( const std::string& thunk_name ) const
+std::shared_ptr< const execution_context_cache > execution_context::cache() const
 {
-   auto iter = _cache.compute_bandwidth.find( thunk_name );
-   KOINOS_ASSERT( iter != _cache.compute_bandwidth.end(), unexpected_state, "unable to find compute bandwidth for ${t}", ("t", thunk_name) );
-   return iter->second;
+   return _cache;
+}
+
+void execution_context::mark_cache_dirty()
+{
+   _cache_dirty = true;
+}
+
+bool execution_context::cache_dirty() const
+{
+   return _cache_dirty;
+}
+
+void execution_context::add_uploaded_contract( const std::string& id, const std::string& bytecode )
+{
+   _uploaded_contracts.emplace_back( id, bytecode );
+}
+
+const std::vector< std::pair< std::string, std::string > >& execution_context::uploaded_contracts() const
+{
+   return _uploaded_contracts;
+}
+
+uint64_t execution_context::get_compute_bandwidth( uint32_t thunk_id ) const
+{
+   if ( _cache && thunk_id < _cache->compute_bandwidth.size() && _cache->compute_bandwidth[ thunk_id ] )
+      return *_cache->compute_bandwidth[ thunk_id ];
+
+   auto enum_value = chain::system_call_id_descriptor()->FindValueByNumber( thunk_id );
+   KOINOS_ASSERT( enum_value, thunk_not_found, "unrecognized thunk id ${id}", ("id", thunk_id) );
+   KOINOS_THROW( unexpected_state, "unable to find compute bandwidth for ${t}", ("t", enum_value->name()) );
 }
 
 const google::protobuf::DescriptorPool& execution_context::descriptor_pool() const
 {
-   KOINOS_ASSERT( _cache.descriptor_pool, unexpected_state, "descriptor pool has not been built" );
-   return *_cache.descriptor_pool;
+   KOINOS_ASSERT( _cache, unexpected_state, "descriptor pool has not been built" );
+   return _cache->descriptor_pool();
 }
 
 std::string execution_context::system_call( uint32_t id, const std::string& args )
 {
-   auto iter = _cache.system_call.find( id );
-   KOINOS_ASSERT( iter != _cache.system_call.end(), unexpected_state, "unable to find call id ${id} in system call cache", ("id", id) );
+   KOINOS_ASSERT( _cache, unexpected_state, "unable to find call id ${id} in system call cache", ("id", id) );
+   auto iter = _cache->system_call.find( id );
+   KOINOS_ASSERT( iter != _cache->system_call.end(), unexpected_state, "unable to find call id ${id} in system call cache", ("id", id) );
 
    const auto& cid      = std::get< 0 >( iter->second );
    const auto& bytecode = std::get< 1 >( iter->second );
    auto entry_point     = std::get< 2 >( iter->second );
    const auto& meta     = std::get< 3 >( iter->second );
 
+   std::string ret;
    push_frame( stack_frame{
       .contract_id = cid,
       .call_privilege = meta.system() ? privilege::kernel_mode : privilege::user_mode,
       .call_args = args,
-      .entry_point = entry_point
+      .entry_point = entry_point,
+      .call_return = &ret
    } );
 
+   clear_exit();
+
    try
    {
       chain::host_api hapi( *this );
       get_backend()->run( hapi, bytecode, meta.hash() );
    }
-   catch( const exit_success& ) {}
    catch( ... ) {
+      clear_exit();
       pop_frame();
       throw;
    }
 
-   return pop_frame().call_return;
+   clear_exit();
+   pop_frame();
+   return ret;
 }
 
 bool execution_context::system_call_exists( uint32_t id ) const
 {
-   return _cache.system_call.find( id ) != _cache.system_call.end();
+   return _cache && _cache->system_call.find( id ) != _cache->system_call.end();
 }
 
 uint32_t execution_context::thunk_translation( uint32_t id ) const
 {
-   auto iter = _cache.thunk.find( id );
-   if ( iter != _cache.thunk.end() )
+   if ( !_cache )
+      return id;
+
+   auto iter = _cache->thunk.find( id );
+   if ( iter != _cache->thunk.end() )
       return iter->second;
    return id;
 }
 
 const crypto::multicodec& execution_context::block_hash_code() const
 {
-   KOINOS_ASSERT( _cache.block_hash_code.has_value(), unexpected_state, "unable to find block hash code" );
-   return *_cache.block_hash_code;
+   KOINOS_ASSERT( _cache, unexpected_state, "unable to find block hash code" );
+   return _cache->block_hash_code;
 }
 
 } // koinos::chain
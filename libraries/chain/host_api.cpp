@@ -41,17 +41,14 @@ uint32_t host_api::invoke_system_call( uint32_t sid, char* ret_ptr, uint32_t ret
             std::string args( arg_ptr, arg_len );
             auto ret = _ctx.system_call( sid, args );
             KOINOS_ASSERT( ret.size() <= ret_len, insufficient_return_buffer, "return buffer too small" );
-            std::memcpy( ret.data(), ret_ptr, ret.size() );
+            std::memcpy( ret_ptr, ret.data(), ret.size() );
             bytes_returned = ret.size();
          }
          else
          {
             auto thunk_id = _ctx.thunk_translation( sid );
             KOINOS_ASSERT( thunk_dispatcher::instance().thunk_exists( thunk_id ), thunk_not_found, "thunk ${tid} does not exist", ("tid", thunk_id) );
-            auto desc = chain::system_call_id_descriptor();
-            auto enum_value = desc->FindValueByNumber( thunk_id );
-            KOINOS_ASSERT( enum_value, thunk_not_found, "unrecognized thunk id ${id}", ("id", thunk_id) );
-            auto compute = _ctx.get_compute_bandwidth( enum_value->name() );
+            auto compute = _ctx.get_compute_bandwidth( thunk_id );
             _ctx.resource_meter().use_compute_bandwidth( compute );
             bytes_returned = thunk_dispatcher::instance().call_thunk( thunk_id, _ctx, ret_ptr, ret_len, arg_ptr, arg_len );
          }
@@ -86,4 +83,9 @@ void host_api::use_meter_ticks( uint64_t meter_ticks )
    }
 }
 
+bool host_api::exit_requested() const
+{
+   return _ctx.exit_requested();
+}
+
 } // koinos::chain
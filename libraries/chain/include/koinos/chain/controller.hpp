@@ -2,35 +2,107 @@
 
 #include <koinos/chain/constants.hpp>
 #include <koinos/chain/pending_state.hpp>
+#include <koinos/chain/prevalidation.hpp>
+#include <koinos/crypto/multihash.hpp>
 #include <koinos/mq/client.hpp>
 #include <koinos/rpc/chain/chain_rpc.pb.h>
 #include <koinos/state_db/state_db_types.hpp>
+#include <koinos/vm_manager/vm_backend.hpp>
 
 #include <any>
 #include <chrono>
 #include <filesystem>
+#include <functional>
+#include <future>
 #include <map>
 #include <memory>
+#include <string>
+#include <vector>
 
 namespace koinos::chain {
 
 namespace detail { class controller_impl; }
 
+enum class submission_stage : uint32_t
+{
+   validated, ///< The block passed its id, merkle root, signature and state checks
+   applied,   ///< The block was applied to a new state node
+   committed, ///< The block was stored and the last irreversible block committed
+   published  ///< The block was broadcast
+};
+
+/**
+ * Futures tracking an asynchronous block submission.
+ *
+ * Each future becomes ready when its stage completes. If the block fails, the futures
+ * of all stages that had not completed yet hold the exception. A block is validated while
+ * it is applied, so validated and applied complete together once the block is applied.
+ */
+struct block_submission
+{
+   std::shared_future< void >                              validated;
+   std::shared_future< void >                              applied;
+   std::shared_future< rpc::chain::submit_block_response > committed;
+   std::shared_future< void >                              published;
+};
+
+/** Called from the controller's worker threads as each stage of a submission completes. Must not throw. */
+using submission_callback = std::function< void( submission_stage ) >;
+
 class controller final
 {
    public:
-      controller( uint64_t read_compute_bandwith_limit = 0 );
+      controller( uint64_t read_compute_bandwith_limit = 0, const std::string& vm_backend_name = vm_manager::get_default_vm_backend_name() );
       ~controller();
 
       void open( const std::filesystem::path& p, const chain::genesis_data& data, bool reset );
       void set_client( std::shared_ptr< mq::client > c );
 
+      /**
+       * Sets a trusted checkpoint for indexing. Off unless set.
+       *
+       * The block at the checkpoint height must match the checkpoint id. Indexed blocks that have
+       * been linked to the checkpoint with link_trusted_block skip block signature verification,
+       * and are not committed until a linked id above them has been matched.
+       */
+      void set_trusted_checkpoint( uint64_t height, const crypto::multihash& id );
+
+      /**
+       * Links the next block id below the trusted checkpoint. Ids must be given in descending
+       * height order, starting with the id of the checkpoint block.
+       */
+      void link_trusted_block( uint64_t height, const crypto::multihash& id );
+
+      /** The hash code of block and transaction ids and merkle roots at the head block */
+      crypto::multicodec get_block_hash_code();
+
+      /** Bounds the memory used by parsed contract modules. Safe to call at any time. */
+      void set_module_cache_size( std::size_t bytes );
+
+      /** Contracts whose modules are parsed when the database is opened and never evicted. Call before open. */
+      void set_hot_contracts( const std::vector< std::string >& contract_ids );
+
       rpc::chain::submit_block_response submit_block(
          const rpc::chain::submit_block_request&,
          uint64_t index_to = 0,
-         std::chrono::system_clock::time_point now = std::chrono::system_clock::now()
+         std::chrono::system_clock::time_point now = std::chrono::system_clock::now(),
+         std::shared_ptr< const prevalidation_cache > prevalidation = nullptr
       );
       rpc::chain::submit_transaction_response submit_transaction( const rpc::chain::submit_transaction_request& );
+
+      /**
+       * Submits a block without waiting for it to be applied. Blocks are applied in the
+       * order they are submitted and broadcast on a separate thread, so the next block
+       * can be applied while the previous one is published.
+       */
+      block_submission async_submit_block(
+         const rpc::chain::submit_block_request&,
+         uint64_t index_to = 0,
+         std::chrono::system_clock::time_point now = std::chrono::system_clock::now(),
+         std::shared_ptr< const prevalidation_cache > prevalidation = nullptr,
+         submission_callback callback = nullptr
+      );
+      std::shared_future< rpc::chain::submit_transaction_response > async_submit_transaction( const rpc::chain::submit_transaction_request& );
       rpc::chain::get_head_info_response get_head_info( const rpc::chain::get_head_info_request&  = {} );
       rpc::chain::get_chain_id_response get_chain_id( const rpc::chain::get_chain_id_request&   = {} );
       rpc::chain::get_fork_heads_response get_fork_heads( const rpc::chain::get_fork_heads_request& = {} );
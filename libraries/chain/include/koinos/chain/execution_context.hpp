@@ -4,6 +4,8 @@
 
 #include <koinos/chain/chronicler.hpp>
 #include <koinos/chain/exceptions.hpp>
+#include <koinos/chain/prepared_block.hpp>
+#include <koinos/chain/prevalidation.hpp>
 #include <koinos/chain/resource_meter.hpp>
 #include <koinos/chain/session.hpp>
 #include <koinos/crypto/elliptic.hpp>
@@ -14,12 +16,17 @@
 #include <koinos/chain/system_call_ids.pb.h>
 #include <koinos/protocol/protocol.pb.h>
 
+#include <array>
 #include <deque>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <tuple>
 #include <variant>
+#include <vector>
 
 namespace koinos::chain {
 
@@ -31,14 +38,18 @@ using koinos::state_db::abstract_state_node;
 using abstract_state_node_ptr = std::shared_ptr< abstract_state_node >;
 using receipt                 = std::variant< std::monostate, protocol::block_receipt, protocol::transaction_receipt >;
 
+/**
+ * A frame borrows its arguments and return buffer from whoever pushed it,
+ * both must outlive the frame.
+ */
 struct stack_frame
 {
-   std::string contract_id;
-   uint32_t    sid = 0;
-   privilege   call_privilege;
-   std::string call_args;
-   uint32_t    entry_point = 0;
-   std::string call_return;
+   std::string      contract_id;
+   uint32_t         sid = 0;
+   privilege        call_privilege;
+   std::string_view call_args;
+   uint32_t         entry_point = 0;
+   std::string*     call_return = nullptr;
 };
 
 enum class intent : uint64_t
@@ -48,15 +59,56 @@ enum class intent : uint64_t
    transaction_application
 };
 
-struct execution_context_cache
+/**
+ * Chain metadata read on every call, built from a state node. Immutable once built
+ * and shared between contexts. The descriptor pool is only needed to decode protocol
+ * fields and is built on first use.
+ */
+class execution_context_cache
 {
-   using system_call_cache_bundle = std::tuple< std::string, std::string, uint32_t, chain::contract_metadata_object >;
+   public:
+      using system_call_cache_bundle = std::tuple< std::string, std::string, uint32_t, chain::contract_metadata_object >;
+
+      execution_context_cache( const abstract_state_node& node );
+
+      const google::protobuf::DescriptorPool& descriptor_pool() const;
+
+      // Compute cost of each native thunk, indexed by thunk id
+      std::array< std::optional< uint64_t >, system_call_id_ARRAYSIZE > compute_bandwidth;
+      std::map< uint32_t, system_call_cache_bundle > system_call;
+      std::map< uint32_t, uint32_t > thunk;
+      crypto::multicodec block_hash_code;
 
-   std::map< std::string, uint64_t > compute_bandwidth;
-   std::unique_ptr< google::protobuf::DescriptorPool > descriptor_pool;
-   std::map< uint32_t, system_call_cache_bundle > system_call;
-   std::map< uint32_t, uint32_t > thunk;
-   std::optional< crypto::multicodec > block_hash_code;
+   private:
+      void build_compute_registry_cache( const abstract_state_node& node );
+      void build_system_call_cache( const abstract_state_node& node );
+      void build_block_hash_code_cache( const abstract_state_node& node );
+
+      std::string                                                 _protocol_descriptor;
+      mutable std::once_flag                                      _descriptor_pool_flag;
+      mutable std::unique_ptr< google::protobuf::DescriptorPool > _descriptor_pool;
+};
+
+/**
+ * Shares execution context caches between contexts. A cache is keyed by the state
+ * node it was built from. A block that does not write any of the cached objects
+ * shares its parent's cache, so caches are only rebuilt when system calls, contracts
+ * or chain metadata change.
+ */
+class execution_context_cache_registry
+{
+   public:
+      static constexpr std::size_t max_entries = 64;
+
+      std::shared_ptr< const execution_context_cache > get( const abstract_state_node_ptr& node );
+      void inherit( const abstract_state_node_ptr& node, const abstract_state_node_ptr& parent );
+      void clear();
+
+   private:
+      void insert( const abstract_state_node_ptr& node, std::shared_ptr< const execution_context_cache > cache );
+
+      std::mutex _mutex;
+      std::map< state_db::state_node_id, std::pair< uint64_t, std::shared_ptr< const execution_context_cache > > > _caches;
 };
 
 class execution_context
@@ -82,15 +134,35 @@ class execution_context
       const protocol::transaction& get_transaction() const;
       void clear_transaction();
 
-      void set_contract_call_args( const std::string& args );
-      const std::string& get_contract_call_args() const;
+      void set_prepared_transaction( const prepared_transaction* );
+      const prepared_transaction* get_prepared_transaction() const;
+
+      void set_prevalidation_cache( std::shared_ptr< const chain::prevalidation_cache > );
+      const chain::prevalidation_cache* get_prevalidation_cache() const;
+
+      /**
+       * A trusted block is linked by hash to a trusted checkpoint, its block
+       * signature is not verified.
+       */
+      void set_trusted_block( bool trusted );
+      bool trusted_block() const;
+
+      std::string_view get_contract_call_args() const;
 
       uint32_t get_contract_entry_point() const;
 
       std::string get_contract_return() const;
       void set_contract_return( const std::string& ret );
 
-      uint64_t get_compute_bandwidth( const std::string& thunk_name ) const;
+      /**
+       * A successful exit is a status rather than an exception. It is requested by the
+       * exit_contract thunk and cleared by whoever ran the contract.
+       */
+      void request_exit();
+      bool exit_requested() const;
+      void clear_exit();
+
+      uint64_t get_compute_bandwidth( uint32_t thunk_id ) const;
 
       /**
        * For now, authority lives on the context.
@@ -102,8 +174,12 @@ class execution_context
       void push_frame( stack_frame&& frame );
       stack_frame pop_frame();
 
-      const std::string& get_caller() const;
-      privilege get_caller_privilege() const;
+      /**
+       * Caller of the frame `depth` frames below the top of the stack. Lets a thunk
+       * look past its own frames without popping them.
+       */
+      const std::string& get_caller( std::size_t depth = 0 ) const;
+      privilege get_caller_privilege( std::size_t depth = 0 ) const;
       uint32_t get_caller_entry_point() const;
 
       void set_privilege( privilege );
@@ -113,6 +189,15 @@ class execution_context
 
       bool read_only() const;
 
+      /**
+       * Kernel objects decoded by system_call::get_decoded_object. An object is valid for the
+       * state node it was read from and the anonymous nodes created from it, writes to the
+       * object evict it.
+       */
+      std::shared_ptr< const google::protobuf::Message > get_decoded_object( uint32_t space_id, const std::string& key ) const;
+      void set_decoded_object( uint32_t space_id, const std::string& key, std::shared_ptr< const google::protobuf::Message > object );
+      void evict_decoded_object( uint32_t space_id, const std::string& key );
+
       chain::resource_meter& resource_meter();
       chain::chronicler& chronicler();
 
@@ -124,6 +209,22 @@ class execution_context
       chain::receipt& receipt();
 
       void build_cache();
+      void set_cache( std::shared_ptr< const execution_context_cache > cache );
+      std::shared_ptr< const execution_context_cache > cache() const;
+
+      /**
+       * Set when a call writes an object the cache is built from. The context keeps
+       * its cache, the change is seen by contexts created afterwards.
+       */
+      void mark_cache_dirty();
+      bool cache_dirty() const;
+
+      /**
+       * Contracts uploaded through this context, as pairs of module id and bytecode,
+       * so their modules can be parsed before their first call.
+       */
+      void add_uploaded_contract( const std::string& id, const std::string& bytecode );
+      const std::vector< std::pair< std::string, std::string > >& uploaded_contracts() const;
 
       const google::protobuf::DescriptorPool& descriptor_pool() const;
 
@@ -135,11 +236,6 @@ class execution_context
    private:
       friend struct frame_restorer;
 
-      void build_compute_registry_cache();
-      void build_descriptor_pool();
-      void build_system_call_cache();
-      void build_block_hash_code_cache();
-
       std::shared_ptr< vm_manager::vm_backend > _vm_backend;
       std::vector< stack_frame >                _stack;
 
@@ -149,6 +245,10 @@ class execution_context
 
       const protocol::block*                    _block = nullptr;
       const protocol::transaction*              _trx = nullptr;
+      const prepared_transaction*               _prepared_trx = nullptr;
+      std::shared_ptr< const prevalidation_cache >  _prevalidation_cache;
+      bool                                      _trusted_block = false;
+      bool                                      _exit_requested = false;
 
       chain::resource_meter                     _resource_meter;
       chain::chronicler                         _chronicler;
@@ -156,7 +256,17 @@ class execution_context
       chain::intent                             _intent;
       chain::receipt                            _receipt;
 
-      execution_context_cache                   _cache;
+      std::shared_ptr< const execution_context_cache > _cache;
+      bool                                      _cache_dirty = false;
+
+      struct decoded_object
+      {
+         abstract_state_node_ptr                            node;
+         std::shared_ptr< const google::protobuf::Message > object;
+      };
+
+      std::map< uint32_t, std::map< std::string, decoded_object > > _decoded_objects;
+      std::vector< std::pair< std::string, std::string > >          _uploaded_contracts;
 };
 
 namespace detail {
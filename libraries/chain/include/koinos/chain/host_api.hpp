@@ -19,6 +19,7 @@ class host_api final : public vm_manager::abstract_host_api
       virtual uint32_t invoke_system_call( uint32_t sid, char* ret_ptr, uint32_t ret_len, const char* arg_ptr, uint32_t arg_len ) override;
       virtual int64_t get_meter_ticks() const override;
       virtual void use_meter_ticks( uint64_t meter_ticks ) override;
+      virtual bool exit_requested() const override;
 };
 
 } // koinos::chain
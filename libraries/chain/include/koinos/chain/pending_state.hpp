@@ -9,18 +9,31 @@
 
 namespace koinos::chain {
 
+class execution_context_cache;
+class execution_context_cache_registry;
+
 class pending_state final
 {
 public:
    void set_client( std::shared_ptr< mq::client > client );
    void set_backend( std::shared_ptr< vm_manager::vm_backend > backend );
+   void set_cache_registry( std::shared_ptr< execution_context_cache_registry > registry );
    state_db::anonymous_state_node_ptr get_state_node();
    void rebuild( state_db::state_node_ptr head );
 
+   /**
+    * The head's shared cache, unless a pending transaction wrote one of the cached
+    * objects, in which case a cache is built from the pending state.
+    */
+   std::shared_ptr< const execution_context_cache > get_cache();
+   void mark_cache_dirty();
+
 private:
-   std::shared_ptr< vm_manager::vm_backend > _backend;
-   std::shared_ptr< mq::client >             _client;
-   state_db::anonymous_state_node_ptr        _pending_state;
+   std::shared_ptr< vm_manager::vm_backend >            _backend;
+   std::shared_ptr< mq::client >                        _client;
+   std::shared_ptr< execution_context_cache_registry >  _cache_registry;
+   state_db::anonymous_state_node_ptr                   _pending_state;
+   bool                                                 _cache_dirty = false;
 };
 
 } // koinos::chain
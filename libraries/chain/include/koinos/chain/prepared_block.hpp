@@ -0,0 +1,49 @@
+#pragma once
+
+#include <koinos/protocol/protocol.pb.h>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace koinos::chain {
+
+/**
+ * A transaction with its serialized header, operations and signatures
+ * computed once so repeated validation does not re-serialize the message.
+ *
+ * The prepared transaction refers to the transaction it was built from
+ * and must not outlive it.
+ */
+struct prepared_transaction
+{
+   explicit prepared_transaction( const protocol::transaction& trx );
+
+   const protocol::transaction* transaction = nullptr;
+
+   std::string                  serialized_header;
+   std::vector< std::string >   serialized_operations;
+   std::string                  concatenated_signatures;
+   std::size_t                  byte_size = 0;
+};
+
+/**
+ * A block with its serialized header, sizes and prepared transactions
+ * computed once when the block is applied.
+ *
+ * The prepared block refers to the block it was built from and must not
+ * outlive it.
+ */
+struct prepared_block
+{
+   explicit prepared_block( const protocol::block& block );
+
+   const protocol::block*              block = nullptr;
+
+   std::string                         serialized_header;
+   std::vector< prepared_transaction > transactions;
+   std::size_t                         byte_size = 0;
+   std::size_t                         transactions_byte_size = 0;
+};
+
+} // koinos::chain
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <koinos/crypto/multihash.hpp>
+#include <koinos/protocol/protocol.pb.h>
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace koinos::chain {
+
+/**
+ * Results computed ahead of block application: public keys recovered by signature
+ * and digest, digests by hash code and data, and merkle roots verified against their
+ * leaves.
+ *
+ * The native hash, verify_merkle_root and recover_public_key system calls read their
+ * result from the cache. The calls are still made and charged, so compute used during
+ * application is unchanged.
+ *
+ * The cache is filled by a single thread and is only read once it has been
+ * handed to the controller.
+ */
+class prevalidation_cache final
+{
+   public:
+      void insert( const std::string& signature, const std::string& digest, std::string public_key );
+      const std::string* find( const std::string& signature, const std::string& digest ) const;
+      std::size_t size() const;
+
+      void insert_hash( uint64_t code, const std::string& data, std::string digest );
+      const std::string* find_hash( uint64_t code, const std::string& data ) const;
+
+      void insert_merkle_root( const std::string& root, const std::vector< std::string >& hashes );
+      bool verified_merkle_root( const std::string& root, const std::vector< std::string >& hashes ) const;
+
+   private:
+      std::unordered_map< std::string, std::string > _keys;
+      std::unordered_map< std::string, std::string > _hashes;
+      std::unordered_set< std::string >              _merkle_roots;
+};
+
+/**
+ * Performs the stateless checks of a block with the chain's block hash code: the
+ * block and transaction ids, the transaction merkle root and the operation merkle
+ * roots. Block and transaction signatures are recovered, and the results are returned
+ * so that they do not need to be recomputed while the block is applied.
+ *
+ * This function does not access state and may be called concurrently on
+ * different blocks.
+ */
+std::shared_ptr< prevalidation_cache > prevalidate_block( const protocol::block& block, crypto::multicodec hash_code );
+
+} // koinos::chain
@@ -42,12 +42,27 @@ public:
    uint64_t compute_bandwidth_remaining();
 
 private:
+   abstract_rc_session* session() const;
 
    uint64_t _disk_storage_remaining      = 0;
    uint64_t _network_bandwidth_remaining = 0;
    uint64_t _compute_bandwidth_remaining = 0;
    resource_limit_data _resource_limit_data;
+
+   /**
+    * The session is held weakly so that a released session stops being charged. The raw
+    * pointer saves locking the weak pointer on every charge, it is only used while the
+    * session has not expired.
+    */
    std::weak_ptr< abstract_rc_session > _session;
+   abstract_rc_session*                 _session_ptr = nullptr;
+
+   /**
+    * Compute bandwidth the session can pay for. Charging compute lowers it tick for tick,
+    * other charges to the session invalidate it.
+    */
+   uint64_t _session_compute_remaining = 0;
+   bool     _session_compute_valid     = false;
 };
 
 } // koinos::chain
@@ -58,6 +58,9 @@ constexpr uint32_t max_object_size = 1024 * 1024; // 1 MB
 
 void assert_permissions( execution_context& context, const object_space& space );
 
+/** Returns true if the object is read in to the execution context cache */
+bool is_cached_object( const object_space& space, const std::string& key );
+
 } // state
 
 } // koinos::chain
@@ -121,4 +121,36 @@ THUNK_DECLARE( void, require_system_authority, system_authorization_type type );
 
 THUNK_DECLARE( verify_signature_result, verify_signature, dsa type, const std::string& public_key, const std::string& signature, const std::string& digest );
 
+namespace system_call {
+
+/**
+ * A fast path for native kernel code reading an object.
+ *
+ * When get_object is not overridden, the object is read with the same stack frame and compute
+ * charge as the system call, without building a get_object_result. When get_object is
+ * overridden, the system call is made. In both cases the value is copied in to buffer.
+ *
+ * Returns a pointer to buffer, or nullptr when the object does not exist.
+ */
+const std::string* get_object_view( execution_context& context, const object_space& space, const std::string& key, std::string& buffer );
+
+/**
+ * Reads a kernel object decoded as a copy of prototype, charged the same as get_object.
+ *
+ * The decoded object is cached on the context and reused while the context stays on the state
+ * node it was read from, until the object is written. Objects outside of kernel space, or read
+ * while get_object is overridden, are decoded on every call.
+ *
+ * Returns nullptr when the object does not exist.
+ */
+std::shared_ptr< const google::protobuf::Message > get_decoded_object( execution_context& context, const object_space& space, const std::string& key, const google::protobuf::Message& prototype );
+
+template< typename T >
+std::shared_ptr< const T > get_decoded_object( execution_context& context, const object_space& space, const std::string& key )
+{
+   return std::static_pointer_cast< const T >( get_decoded_object( context, space, key, T::default_instance() ) );
+}
+
+} // system_call
+
 } // koinos::chain
@@ -4,284 +4,399 @@
 #include <koinos/chain/exceptions.hpp>
 #include <koinos/chain/system_calls.hpp>
 
-#include <google/protobuf/message.h>
 #include <google/protobuf/descriptor.h>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/message.h>
+#include <google/protobuf/stubs/common.h>
+#include <google/protobuf/wire_format_lite.h>
 
-#include <any>
+#include <array>
 #include <cstdint>
-#include <functional>
-#include <map>
+#include <limits>
+#include <string>
+#include <tuple>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace koinos::chain {
 
 namespace detail
 {
-   template< typename T, typename Lambda >
-   std::enable_if_t< std::is_same_v< decltype( std::declval< Lambda >()( std::declval< int >() ) ), T >, void >
-   iterate_repeated_field( const google::protobuf::Message& msg, const google::protobuf::FieldDescriptor* fd, std::vector< T >& v, Lambda&& l )
-   {
-      auto ref = msg.GetReflection();
-      for( int i = 0; i < ref->FieldSize( msg, fd ); i++ )
-      {
-         v.emplace_back( l( i ) );
-      }
-   }
+   using google::protobuf::internal::WireFormatLite;
 
-   template< typename T, typename Lambda >
-   std::enable_if_t< !std::is_same_v< decltype( std::declval< Lambda >()( std::declval< int >() ) ), T >, void >
-   iterate_repeated_field( const google::protobuf::Message& msg, const google::protobuf::FieldDescriptor* fd, std::vector< T >& v, Lambda&& l ) {}
+   template< typename T >
+   struct is_vector : std::false_type {};
 
    template< typename T >
-   std::enable_if_t< std::is_base_of_v< google::protobuf::Message, T >, void >
-   copy_from( const google::protobuf::Message& m, T& t )
+   struct is_vector< std::vector< T > > : std::true_type {};
+
+   // Reads the length of a field as the generated parser does, as a varint of at most five bytes
+   inline bool read_size( google::protobuf::io::CodedInputStream& input, int& length )
    {
-      t.CopyFrom( m );
+      auto start = input.CurrentPosition();
+      return input.ReadVarintSizeAsInt( &length ) && input.CurrentPosition() - start <= 5;
    }
 
+   // Reads a single value of a thunk argument from the wire. Integers are encoded as varints,
+   // enums as their underlying integer values.
    template< typename T >
-   std::enable_if_t< !std::is_base_of_v< google::protobuf::Message, T >, void >
-   copy_from( const google::protobuf::Message& m, T& t ) {}
-
-   inline std::any get_type_from_field_impl( const google::protobuf::Message& msg, const google::protobuf::FieldDescriptor* fd )
+   bool read_value( google::protobuf::io::CodedInputStream& input, T& value )
    {
-      auto ref = msg.GetReflection();
-      std::any field;
-
-      switch( fd->cpp_type() )
+      if constexpr ( std::is_base_of_v< google::protobuf::Message, T > )
       {
-         case google::protobuf::FieldDescriptor::CppType::CPPTYPE_INT64:
-            field = ref->GetInt64( msg, fd );
-            break;
-         case google::protobuf::FieldDescriptor::CppType::CPPTYPE_UINT64:
-            field = ref->GetUInt64( msg, fd );
-            break;
-         case google::protobuf::FieldDescriptor::CppType::CPPTYPE_INT32:
-            field = ref->GetInt32( msg, fd );
-            break;
-         case google::protobuf::FieldDescriptor::CppType::CPPTYPE_UINT32:
-            field = ref->GetUInt32( msg, fd );
-            break;
-         case google::protobuf::FieldDescriptor::CppType::CPPTYPE_BOOL:
-            field = ref->GetBool( msg, fd );
-            break;
-         case google::protobuf::FieldDescriptor::CppType::CPPTYPE_STRING:
-            field = ref->GetString( msg, fd );
-            break;
-         case google::protobuf::FieldDescriptor::CppType::CPPTYPE_MESSAGE:
-            field = &ref->GetMessage( msg, fd );
-            break;
-         case google::protobuf::FieldDescriptor::CppType::CPPTYPE_ENUM:
-            field = ref->GetEnumValue( msg, fd );
-            break;
-         case google::protobuf::FieldDescriptor::CppType::CPPTYPE_FLOAT:
-            field = ref->GetFloat( msg, fd );
-            break;
-         case google::protobuf::FieldDescriptor::CppType::CPPTYPE_DOUBLE:
-            field = ref->GetDouble( msg, fd );
-            break;
-         default:
-            assert( "Type not handled for thunk args." );
+         int length;
+         if ( !read_size( input, length ) )
+            return false;
+
+         // A limit past the end of the buffer is clamped to it, so a truncated field is caught here
+         auto limit = input.PushLimit( length );
+         if ( input.BytesUntilLimit() != length )
+            return false;
+
+         bool read = value.MergePartialFromCodedStream( &input ) && input.ConsumedEntireMessage();
+         input.PopLimit( limit );
+         return read;
       }
+      else if constexpr ( std::is_same_v< T, std::string > )
+      {
+         int length;
+         return read_size( input, length ) && input.ReadString( &value, length );
+      }
+      else if constexpr ( std::is_enum_v< T > )
+      {
+         int v;
+         if ( !WireFormatLite::ReadPrimitive< int, WireFormatLite::TYPE_ENUM >( &input, &v ) )
+            return false;
 
-      return field;
+         value = T( v );
+         return true;
+      }
+      else if constexpr ( std::is_same_v< T, bool > )
+      {
+         return WireFormatLite::ReadPrimitive< bool, WireFormatLite::TYPE_BOOL >( &input, &value );
+      }
+      else if constexpr ( std::is_same_v< T, int64_t > )
+      {
+         return WireFormatLite::ReadPrimitive< int64_t, WireFormatLite::TYPE_INT64 >( &input, &value );
+      }
+      else if constexpr ( std::is_same_v< T, uint64_t > )
+      {
+         return WireFormatLite::ReadPrimitive< uint64_t, WireFormatLite::TYPE_UINT64 >( &input, &value );
+      }
+      else if constexpr ( std::is_same_v< T, int32_t > )
+      {
+         return WireFormatLite::ReadPrimitive< int32_t, WireFormatLite::TYPE_INT32 >( &input, &value );
+      }
+      else if constexpr ( std::is_same_v< T, uint32_t > )
+      {
+         return WireFormatLite::ReadPrimitive< uint32_t, WireFormatLite::TYPE_UINT32 >( &input, &value );
+      }
+      else if constexpr ( std::is_same_v< T, float > )
+      {
+         return WireFormatLite::ReadPrimitive< float, WireFormatLite::TYPE_FLOAT >( &input, &value );
+      }
+      else if constexpr ( std::is_same_v< T, double > )
+      {
+         return WireFormatLite::ReadPrimitive< double, WireFormatLite::TYPE_DOUBLE >( &input, &value );
+      }
+      else
+      {
+         static_assert( !std::is_same_v< T, T >, "type not handled for thunk args" );
+      }
    }
 
-   // Parses through a repeated field and puts values in a vector.
    template< typename T >
-   std::any get_type_from_repeated_field( const google::protobuf::Message& msg, const google::protobuf::FieldDescriptor* fd )
+   constexpr WireFormatLite::WireType wire_type()
    {
-      auto ref = msg.GetReflection();
-      std::any field;
+      if constexpr ( std::is_base_of_v< google::protobuf::Message, T > || std::is_same_v< T, std::string > )
+         return WireFormatLite::WIRETYPE_LENGTH_DELIMITED;
+      else if constexpr ( std::is_same_v< T, float > )
+         return WireFormatLite::WIRETYPE_FIXED32;
+      else if constexpr ( std::is_same_v< T, double > )
+         return WireFormatLite::WIRETYPE_FIXED64;
+      else
+         return WireFormatLite::WIRETYPE_VARINT;
+   }
 
-      switch( fd->cpp_type() )
+   // Skips a field the generated parser would accept. Groups are not expected in thunk arguments and
+   // are left to the generated parser.
+   inline bool skip_field( google::protobuf::io::CodedInputStream& input, uint32_t tag )
+   {
+      switch ( WireFormatLite::GetTagWireType( tag ) )
       {
-         case google::protobuf::FieldDescriptor::CppType::CPPTYPE_INT64:
+         case WireFormatLite::WIRETYPE_LENGTH_DELIMITED:
          {
-            std::vector< int64_t > v;
-            iterate_repeated_field( msg, fd, v, [&]( int i )
-            {
-               return ref->GetRepeatedInt64( msg, fd, i );
-            } );
-            field = std::move( v );
-            break;
-         }
-         case google::protobuf::FieldDescriptor::CppType::CPPTYPE_UINT64:
-         {
-            std::vector< uint64_t > v;
-            iterate_repeated_field( msg, fd, v, [&]( int i )
-            {
-               return ref->GetRepeatedUInt64( msg, fd, i );
-            } );
-            field = std::move( v );
-            break;
+            int length;
+            return read_size( input, length ) && input.Skip( length );
          }
-         case google::protobuf::FieldDescriptor::CppType::CPPTYPE_INT32:
-         {
-            std::vector< int32_t > v;
-            iterate_repeated_field( msg, fd, v, [&]( int i )
-            {
-               return ref->GetRepeatedInt32( msg, fd, i );
-            } );
-            field = std::move( v );
-            break;
-         }
-         case google::protobuf::FieldDescriptor::CppType::CPPTYPE_UINT32:
-         {
-            std::vector< uint32_t > v;
-            iterate_repeated_field( msg, fd, v, [&]( int i )
-            {
-               return ref->GetRepeatedUInt32( msg, fd, i );
-            } );
-            field = std::move( v );
-            break;
-         }
-         case google::protobuf::FieldDescriptor::CppType::CPPTYPE_BOOL:
-         {
-            std::vector< bool > v;
-            iterate_repeated_field( msg, fd, v, [&]( int i )
-            {
-               return ref->GetRepeatedBool( msg, fd, i );
-            } );
-            field = std::move( v );
-            break;
-         }
-         case google::protobuf::FieldDescriptor::CppType::CPPTYPE_STRING:
-         {
-            std::vector< std::string > v;
-            iterate_repeated_field( msg, fd, v, [&]( int i )
-            {
-               return ref->GetRepeatedString( msg, fd, i );
-            } );
-            field = std::move( v );
-            break;
-         }
-         case google::protobuf::FieldDescriptor::CppType::CPPTYPE_MESSAGE:
-         {
-            std::vector< T > v;
-            iterate_repeated_field( msg, fd, v, [&]( int i )
-            {
-               T t;
-               copy_from( ref->GetRepeatedMessage( msg, fd, i ), t );
-               return t;
-            } );
-            field = std::move( v );
-            break;
-         }
-         case google::protobuf::FieldDescriptor::CppType::CPPTYPE_ENUM:
+         case WireFormatLite::WIRETYPE_START_GROUP:
+         case WireFormatLite::WIRETYPE_END_GROUP:
+            return false;
+         default:
+            return WireFormatLite::SkipField( &input, tag );
+      }
+   }
+
+   template< typename T >
+   bool valid_utf8( const T& value )
+   {
+      if constexpr ( std::is_same_v< T, std::string > )
+         return google::protobuf::internal::IsStructurallyValidUTF8( value.data(), int( value.size() ) );
+      else
+         return true;
+   }
+
+   // Reads a field of a thunk argument, appending to repeated fields whether or not they are packed.
+   // A field with an unexpected wire type is skipped, as a generated parser would. Proto3 strings are
+   // rejected when they are not valid UTF-8, also as a generated parser would.
+   template< typename T >
+   bool read_field( google::protobuf::io::CodedInputStream& input, uint32_t tag, T& value, bool utf8 )
+   {
+      if constexpr ( is_vector< T >::value )
+      {
+         using value_type = typename T::value_type;
+
+         if constexpr ( wire_type< value_type >() != WireFormatLite::WIRETYPE_LENGTH_DELIMITED )
          {
-            std::vector< int > v;
-            iterate_repeated_field( msg, fd, v, [&]( int i )
+            if ( WireFormatLite::GetTagWireType( tag ) == WireFormatLite::WIRETYPE_LENGTH_DELIMITED )
             {
-               return ref->GetRepeatedEnum( msg, fd, i );
-            } );
-            field = std::move( v );
-            break;
+               int length;
+               if ( !read_size( input, length ) )
+                  return false;
+
+               auto limit = input.PushLimit( length );
+               if ( input.BytesUntilLimit() != length )
+                  return false;
+
+               while ( input.BytesUntilLimit() > 0 )
+               {
+                  value_type v;
+                  if ( !read_value( input, v ) )
+                     return false;
+
+                  value.push_back( v );
+               }
+
+               input.PopLimit( limit );
+               return true;
+            }
          }
-         default:
-            assert( "Type not handled for thunk args." );
+
+         if ( WireFormatLite::GetTagWireType( tag ) != wire_type< value_type >() )
+            return skip_field( input, tag );
+
+         value_type v;
+         if ( !read_value( input, v ) || ( utf8 && !valid_utf8( v ) ) )
+            return false;
+
+         value.push_back( std::move( v ) );
+         return true;
       }
+      else
+      {
+         if ( WireFormatLite::GetTagWireType( tag ) != wire_type< T >() )
+            return skip_field( input, tag );
 
-      return field;
+         // A field seen more than once is merged in to messages and replaces other values, as in a generated parser
+         return read_value( input, value ) && ( !utf8 || valid_utf8( value ) );
+      }
    }
 
-   // Overload to capture when field is repeated (vector)
-   template< typename T >
-   void get_type_from_field( const google::protobuf::Message& msg, const google::protobuf::FieldDescriptor* fd, std::vector< T >& v )
+   template< typename Args, std::size_t N, std::size_t... I >
+   bool read_argument( google::protobuf::io::CodedInputStream& input, uint32_t tag, Args& args, const std::array< bool, N >& utf8, std::index_sequence< I... > )
    {
-      v = std::any_cast< std::vector< T > >( get_type_from_repeated_field< T >( msg, fd ) );
+      auto number = WireFormatLite::GetTagFieldNumber( tag );
+      if ( number == 0 )
+         return false;
+
+      bool read = true;
+      bool known = ( ( number == int( I + 1 ) && ( read = read_field( input, tag, std::get< I >( args ), utf8[ I ] ), true ) ) || ... );
+      return known ? read : skip_field( input, tag );
    }
 
-   // Overload to capture when field is a Message
-   template< typename T >
-   std::enable_if_t< std::is_base_of_v< google::protobuf::Message, T >, void >
-   get_type_from_field( const google::protobuf::Message& msg, const google::protobuf::FieldDescriptor* fd, T& t )
+   // Reads the fields straight from the argument buffer in to a tuple of typed values. Returns false
+   // on any input the generated parser would reject.
+   template< typename... Values >
+   bool decode_arguments( const char* arg_ptr, uint32_t arg_len, std::tuple< Values... >& args, const std::array< bool, sizeof...( Values ) >& utf8 )
    {
-      auto ptr = std::any_cast< const google::protobuf::Message* >( get_type_from_field_impl( msg, fd ) );
-      t.CopyFrom( *ptr );
+      if ( arg_len > uint32_t( std::numeric_limits< int >::max() ) )
+         return false;
+
+      google::protobuf::io::CodedInputStream input( reinterpret_cast< const uint8_t* >( arg_ptr ), int( arg_len ) );
+
+      for ( auto start = input.CurrentPosition(); auto tag = input.ReadTag(); start = input.CurrentPosition() )
+      {
+         // Tags are at most five bytes to the generated parser, longer ones are not truncated
+         if ( input.CurrentPosition() - start > 5 )
+            return false;
+
+         if ( !read_argument( input, tag, args, utf8, std::index_sequence_for< Values... >() ) )
+            return false;
+      }
+
+      return input.ConsumedEntireMessage();
    }
 
-   // Overload to capture when field is an Enum
-   template< typename T >
-   std::enable_if_t< !std::is_base_of_v< google::protobuf::Message, T > && std::is_enum_v< T >, void >
-   get_type_from_field( const google::protobuf::Message& msg, const google::protobuf::FieldDescriptor* fd, T& t )
+   // Thunk argument I is read from field number I + 1 of the argument message
+   template< typename ArgStruct, typename... Values, std::size_t... I >
+   void check_argument_fields( uint32_t id, std::index_sequence< I... > )
    {
-      t = T( std::any_cast< std::underlying_type_t< T > >( get_type_from_field_impl( msg, fd ) ) );
+      auto desc = ArgStruct::descriptor();
+
+      KOINOS_ASSERT(
+         desc->field_count() == int( sizeof...( Values ) ),
+         field_not_found,
+         "thunk ${id} takes ${n} arguments but ${m} has ${f} fields",
+         ("id", id)("n", sizeof...( Values ))("m", desc->full_name())("f", desc->field_count())
+      );
+
+      ( [&]()
+      {
+         auto fd = desc->FindFieldByNumber( int( I + 1 ) );
+         KOINOS_ASSERT( fd, field_not_found, "thunk ${id} argument ${i} has no field number ${n} in ${m}", ("id", id)("i", I)("n", I + 1)("m", desc->full_name()) );
+         KOINOS_ASSERT(
+            fd->is_repeated() == is_vector< Values >::value,
+            unexpected_field_type,
+            "thunk ${id} argument ${i} does not match the repetition of field ${f}",
+            ("id", id)("i", I)("f", fd->full_name())
+         );
+      }(), ... );
    }
 
-   // Overload to capture when field is neither
-   template< typename T >
-   std::enable_if_t< !std::is_base_of_v< google::protobuf::Message, T > && !std::is_enum_v< T >, void >
-   get_type_from_field( const google::protobuf::Message& msg, const google::protobuf::FieldDescriptor* fd, T& t )
+   // Whether each argument field is a proto3 string, which the generated parser validates as UTF-8
+   template< typename ArgStruct, std::size_t N >
+   std::array< bool, N > utf8_fields()
    {
-      t = std::any_cast< T >( get_type_from_field_impl( msg, fd ) );
+      std::array< bool, N > utf8 = {};
+      auto desc = ArgStruct::descriptor();
+
+      for ( std::size_t i = 0; i < N; i++ )
+      {
+         auto fd = desc->FindFieldByNumber( int( i + 1 ) );
+         utf8[ i ] = fd && fd->type() == google::protobuf::FieldDescriptor::TYPE_STRING && fd->file()->syntax() == google::protobuf::FileDescriptor::SYNTAX_PROTO3;
+      }
+
+      return utf8;
    }
 
-   // Variadic recusrive template to convert fields of a message in to a tuple
-   // Arg type information is assumed to match the fields of the corresponding Message
-   // Each call strips off the next argument (T), parses it with get_type_from_field,
-   // adds it to the tuple and recusively calls with the remaining arguments (Ts).
-   // The base case is when there are no more fields remaining (Ts is empty).
-   template< typename T, typename... Ts >
-   std::tuple< T, Ts... > message_to_tuple_impl( const google::protobuf::Message& msg )
+   // Reads a value of a thunk argument from a parsed message, index is -1 for a singular field
+   template< typename T >
+   T reflect_value( const google::protobuf::Message& msg, const google::protobuf::FieldDescriptor* fd, int index )
    {
-      // Get our type
-      constexpr std::size_t fields_remaining = sizeof...( Ts );
-      auto desc = msg.GetDescriptor();
-      auto fd = desc->FindFieldByNumber( desc->field_count() - fields_remaining );
-      T t;
-      get_type_from_field( msg, fd, t );
+      auto ref = msg.GetReflection();
+      bool repeated = index >= 0;
+
+      if constexpr ( std::is_base_of_v< google::protobuf::Message, T > )
+      {
+         T value;
+         value.CopyFrom( repeated ? ref->GetRepeatedMessage( msg, fd, index ) : ref->GetMessage( msg, fd ) );
+         return value;
+      }
+      else if constexpr ( std::is_same_v< T, std::string > )
+         return repeated ? ref->GetRepeatedString( msg, fd, index ) : ref->GetString( msg, fd );
+      else if constexpr ( std::is_enum_v< T > )
+         return T( repeated ? ref->GetRepeatedEnumValue( msg, fd, index ) : ref->GetEnumValue( msg, fd ) );
+      else if constexpr ( std::is_same_v< T, bool > )
+         return repeated ? ref->GetRepeatedBool( msg, fd, index ) : ref->GetBool( msg, fd );
+      else if constexpr ( std::is_same_v< T, int64_t > )
+         return repeated ? ref->GetRepeatedInt64( msg, fd, index ) : ref->GetInt64( msg, fd );
+      else if constexpr ( std::is_same_v< T, uint64_t > )
+         return repeated ? ref->GetRepeatedUInt64( msg, fd, index ) : ref->GetUInt64( msg, fd );
+      else if constexpr ( std::is_same_v< T, int32_t > )
+         return repeated ? ref->GetRepeatedInt32( msg, fd, index ) : ref->GetInt32( msg, fd );
+      else if constexpr ( std::is_same_v< T, uint32_t > )
+         return repeated ? ref->GetRepeatedUInt32( msg, fd, index ) : ref->GetUInt32( msg, fd );
+      else if constexpr ( std::is_same_v< T, float > )
+         return repeated ? ref->GetRepeatedFloat( msg, fd, index ) : ref->GetFloat( msg, fd );
+      else if constexpr ( std::is_same_v< T, double > )
+         return repeated ? ref->GetRepeatedDouble( msg, fd, index ) : ref->GetDouble( msg, fd );
+      else
+         static_assert( !std::is_same_v< T, T >, "type not handled for thunk args" );
+   }
 
-      if constexpr ( fields_remaining > 0 )
-         return std::tuple_cat( std::tuple< T >( std::move( t ) ), message_to_tuple_impl< Ts... >( msg ) );
+   template< typename T >
+   void reflect_field( const google::protobuf::Message& msg, const google::protobuf::FieldDescriptor* fd, T& value )
+   {
+      if constexpr ( is_vector< T >::value )
+      {
+         for ( int i = 0; i < msg.GetReflection()->FieldSize( msg, fd ); i++ )
+            value.push_back( reflect_value< typename T::value_type >( msg, fd, i ) );
+      }
       else
-         return std::tuple< T >( std::move( t ) );
+      {
+         value = reflect_value< T >( msg, fd, -1 );
+      }
    }
 
-   template< typename... Ts >
-   std::tuple< std::decay_t< Ts >... > message_to_tuple( const google::protobuf::Message& msg )
+   template< typename Args, std::size_t... I >
+   void reflect_arguments( const google::protobuf::Message& msg, Args& args, std::index_sequence< I... > )
    {
-      return message_to_tuple_impl< std::decay_t< Ts >... >( msg );
+      auto desc = msg.GetDescriptor();
+      ( reflect_field( msg, desc->FindFieldByNumber( int( I + 1 ) ), std::get< I >( args ) ), ... );
    }
 
-   template<>
-   inline std::tuple<> message_to_tuple<>( const google::protobuf::Message& )
+   /*
+    * Each thunk gets its own decoder, with no intermediate message and no reflection. Arguments the
+    * decoder rejects are parsed by the generated parser and read through reflection instead, so a
+    * thunk sees the same arguments for any input as it would from ParseFromString, including the
+    * fields a failed parse leaves set.
+    */
+   template< typename ArgStruct, typename... Values >
+   void decode_arguments( const char* arg_ptr, uint32_t arg_len, std::tuple< Values... >& args )
    {
-      return std::tuple<>();
+      static const auto utf8 = utf8_fields< ArgStruct, sizeof...( Values ) >();
+
+      if ( decode_arguments( arg_ptr, arg_len, args, utf8 ) )
+         return;
+
+      ArgStruct msg;
+      msg.ParseFromString( std::string( arg_ptr, arg_len ) );
+
+      args = {};
+      reflect_arguments( msg, args, std::index_sequence_for< Values... >() );
    }
 
    /*
     * std::apply takes a function and a tuple and calls the function with the contents of the tuple
-    * as the arguments. The only "trick" here is converting a reflected object in to an equivalent
-    * tuple. That is handled as part of the reflection macro to generate the needed code. We cat a
-    * tuple containing just the apply context as the first argument and then call in to the thunk.
+    * as the arguments. The thunk is called with the apply context followed by the decoded arguments.
+    * Strings and messages are passed by reference in to the decoded arguments, so they are not copied.
     *
     * Two versions exist of the function, one that serializes the return value and one that does not.
     */
    template< typename ArgStruct, typename RetStruct, typename ThunkReturn, typename... ThunkArgs >
    typename std::enable_if< std::is_same< ThunkReturn, void >::value, uint32_t >::type
-   call_thunk_impl( const std::function< ThunkReturn(execution_context&, ThunkArgs...) >& thunk, execution_context& ctx, char* ret_ptr, uint32_t ret_len, ArgStruct& arg )
+   call_thunk_impl( ThunkReturn (*thunk)(execution_context&, ThunkArgs...), execution_context& ctx, char* ret_ptr, uint32_t ret_len, const char* arg_ptr, uint32_t arg_len )
    {
-      auto thunk_args = std::tuple_cat( std::tuple< execution_context& >( ctx ), message_to_tuple< ThunkArgs... >( arg ) );
-      std::apply( thunk, thunk_args );
+      std::tuple< std::decay_t< ThunkArgs >... > args;
+      decode_arguments< ArgStruct >( arg_ptr, arg_len, args );
+      std::apply( [&]( auto&... a ) { thunk( ctx, a... ); }, args );
       return 0;
    }
 
    template< typename ArgStruct, typename RetStruct, typename ThunkReturn, typename... ThunkArgs >
    typename std::enable_if< !std::is_same< ThunkReturn, void >::value, uint32_t >::type
-   call_thunk_impl( const std::function< ThunkReturn(execution_context&, ThunkArgs...) >& thunk, execution_context& ctx, char* ret_ptr, uint32_t ret_len, ArgStruct& arg )
+   call_thunk_impl( ThunkReturn (*thunk)(execution_context&, ThunkArgs...), execution_context& ctx, char* ret_ptr, uint32_t ret_len, const char* arg_ptr, uint32_t arg_len )
    {
       static_assert( std::is_same< RetStruct, ThunkReturn >::value, "thunk return does not match defined return in koinos-proto" );
-      auto thunk_args = std::tuple_cat( std::tuple< execution_context& >( ctx ), message_to_tuple< ThunkArgs... >( arg ) );
-      auto ret = std::apply( thunk, thunk_args );
-      std::string s;
-      ret.SerializeToString( &s );
-      KOINOS_ASSERT( s.size() <= ret_len, koinos::exception, "return buffer is not large enough for the return value" );
-      #pragma message "TODO: We should avoid making copies where possible (Issue #473)"
-      std::memcpy( ret_ptr, s.c_str(), s.size() );
-      return s.size();
+      std::tuple< std::decay_t< ThunkArgs >... > args;
+      decode_arguments< ArgStruct >( arg_ptr, arg_len, args );
+      auto ret = std::apply( [&]( auto&... a ) { return thunk( ctx, a... ); }, args );
+
+      // The result is serialized directly in to the return buffer once it is known to fit
+      auto size = ret.ByteSizeLong();
+      KOINOS_ASSERT( size <= ret_len, koinos::exception, "return buffer is not large enough for the return value" );
+      ret.SerializeWithCachedSizesToArray( reinterpret_cast< uint8_t* >( ret_ptr ) );
+      return size;
    }
 
+   // Every thunk signature gets a unique address, used to check pass through calls against the registered thunk
+   template< typename Thunk >
+   struct thunk_signature
+   {
+      static constexpr char tag = 0;
+   };
+
 } // detail
 
 /**
@@ -308,23 +423,25 @@ class thunk_dispatcher
       template< typename ThunkReturn, typename... ThunkArgs >
       auto call_thunk( uint32_t id, execution_context& ctx, ThunkArgs&... args ) const
       {
-         auto it = _pass_through_map.find( id );
-         KOINOS_ASSERT( it != _pass_through_map.end(), thunk_not_found, "thunk ${id} not found", ("id", id ) );
-         return std::any_cast< std::function<ThunkReturn(execution_context&, ThunkArgs...)> >(it->second)( ctx, args... );
+         using thunk_type = ThunkReturn (*)(execution_context&, ThunkArgs...);
+
+         const auto& entry = get_entry( id );
+         KOINOS_ASSERT( entry.signature == &detail::thunk_signature< thunk_type >::tag, thunk_not_found, "thunk ${id} does not match the system call signature", ("id", id) );
+         return reinterpret_cast< thunk_type >( entry.thunk )( ctx, args... );
       }
 
       template< typename ArgStruct, typename RetStruct, typename ThunkReturn, typename... ThunkArgs >
       void register_thunk( uint32_t id, ThunkReturn (*thunk_ptr)(execution_context&, ThunkArgs...) )
       {
-         std::function<ThunkReturn(execution_context&, ThunkArgs...)> thunk = thunk_ptr;
-         _dispatch_map.insert_or_assign( id, [thunk]( execution_context& ctx, char* ret_ptr, uint32_t ret_len, const char* arg_ptr, uint32_t arg_len ) -> uint32_t
-         {
-            ArgStruct args;
-            std::string s( arg_ptr, arg_len );
-            args.ParseFromString( s );
-            return detail::call_thunk_impl< ArgStruct, RetStruct >( thunk, ctx, ret_ptr, ret_len, args );
-         });
-         _pass_through_map.insert_or_assign( id, thunk );
+         using thunk_type = ThunkReturn (*)(execution_context&, ThunkArgs...);
+
+         KOINOS_ASSERT( id < _thunks.size(), thunk_not_found, "thunk id ${id} is out of range", ("id", id) );
+         detail::check_argument_fields< ArgStruct, std::decay_t< ThunkArgs >... >( id, std::index_sequence_for< ThunkArgs... >() );
+
+         auto& entry = _thunks[ id ];
+         entry.handler   = &dispatch< ArgStruct, RetStruct, ThunkReturn, ThunkArgs... >;
+         entry.thunk     = reinterpret_cast< erased_thunk >( thunk_ptr );
+         entry.signature = &detail::thunk_signature< thunk_type >::tag;
       }
 
       bool thunk_exists( uint32_t id ) const;
@@ -333,10 +450,33 @@ class thunk_dispatcher
    private:
       thunk_dispatcher();
 
-      typedef std::function< uint32_t(execution_context&, char* ret_ptr, uint32_t ret_len, const char* arg_ptr, uint32_t arg_len) > generic_thunk_handler;
+      using erased_thunk = void (*)();
+
+      typedef uint32_t (*generic_thunk_handler)( erased_thunk, execution_context&, char* ret_ptr, uint32_t ret_len, const char* arg_ptr, uint32_t arg_len );
+
+      struct thunk_entry
+      {
+         generic_thunk_handler handler   = nullptr;
+         erased_thunk          thunk     = nullptr;
+         const void*           signature = nullptr;
+      };
+
+      template< typename ArgStruct, typename RetStruct, typename ThunkReturn, typename... ThunkArgs >
+      static uint32_t dispatch( erased_thunk thunk, execution_context& ctx, char* ret_ptr, uint32_t ret_len, const char* arg_ptr, uint32_t arg_len )
+      {
+         return detail::call_thunk_impl< ArgStruct, RetStruct >( reinterpret_cast< ThunkReturn (*)(execution_context&, ThunkArgs...) >( thunk ), ctx, ret_ptr, ret_len, arg_ptr, arg_len );
+      }
+
+      const thunk_entry& get_entry( uint32_t id ) const
+      {
+         KOINOS_ASSERT( id < _thunks.size() && _thunks[ id ].handler, thunk_not_found, "thunk ${id} not found", ("id", id) );
+         return _thunks[ id ];
+      }
+
+      // Thunk ids are dense, so the table is indexed directly by id
+      static_assert( system_call_id_ARRAYSIZE <= 0x10000, "system call ids are too sparse for a dense dispatch table" );
 
-      std::map< uint32_t, generic_thunk_handler > _dispatch_map;
-      std::map< uint32_t, std::any >              _pass_through_map;
+      std::array< thunk_entry, system_call_id_ARRAYSIZE > _thunks;
 };
 
 } // koinos::chain
@@ -264,10 +264,7 @@ namespace koinos::chain::detail {
             else                                                                                                           \
             {                                                                                                              \
                auto _thunk_id = context.thunk_translation( _sid );                                                         \
-               auto _desc = chain::system_call_id_descriptor();                                                            \
-               auto _enum_value = _desc->FindValueByNumber( _thunk_id );                                                   \
-               KOINOS_ASSERT( _enum_value, thunk_not_found, "unrecognized thunk id ${id}", ("id", _thunk_id) );            \
-               auto _compute = context.get_compute_bandwidth( _enum_value->name() );                                       \
+               auto _compute = context.get_compute_bandwidth( _thunk_id );                                                 \
                context.resource_meter().use_compute_bandwidth( _compute );                                                 \
                BOOST_PP_IF(_THUNK_IS_VOID(RETURN_TYPE),,_ret =)                                                            \
                   thunk_dispatcher::instance().call_thunk<                                                                 \
@@ -24,10 +24,31 @@ void pending_state::set_client( std::shared_ptr< mq::client > client )
    _client = client;
 }
 
+void pending_state::set_cache_registry( std::shared_ptr< execution_context_cache_registry > registry )
+{
+   _cache_registry = registry;
+}
+
+std::shared_ptr< const execution_context_cache > pending_state::get_cache()
+{
+   KOINOS_ASSERT( _pending_state, pending_state_error, "pending state does not exist" );
+
+   if ( _cache_dirty || !_cache_registry )
+      return std::make_shared< const execution_context_cache >( *_pending_state );
+
+   return _cache_registry->get( _pending_state->get_parent() );
+}
+
+void pending_state::mark_cache_dirty()
+{
+   _cache_dirty = true;
+}
+
 void pending_state::rebuild( state_db::state_node_ptr head )
 {
    LOG(debug) << "Rebuilding pending state";
    _pending_state = head->create_anonymous_node();
+   _cache_dirty = false;
 
    if ( _client && _client->is_running() )
    {
@@ -39,7 +60,7 @@ void pending_state::rebuild( state_db::state_node_ptr head )
       execution_context ctx( _backend, intent::transaction_application );
 
       ctx.set_state_node( _pending_state );
-      ctx.build_cache();
+      ctx.set_cache( get_cache() );
 
       ctx.push_frame( stack_frame {
          .call_privilege = privilege::kernel_mode
@@ -72,6 +93,9 @@ void pending_state::rebuild( state_db::state_node_ptr head )
             _client->broadcast( "koinos.transaction.fail", util::converter::as< std::string >( ptf ) );
          }
       }
+
+      if ( ctx.cache_dirty() )
+         _cache_dirty = true;
    }
 }
 
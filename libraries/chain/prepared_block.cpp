@@ -0,0 +1,38 @@
+#include <koinos/chain/prepared_block.hpp>
+
+#include <koinos/util/conversion.hpp>
+
+namespace koinos::chain {
+
+prepared_transaction::prepared_transaction( const protocol::transaction& trx ) :
+   transaction( &trx ),
+   serialized_header( util::converter::as< std::string >( trx.header() ) ),
+   byte_size( trx.ByteSizeLong() )
+{
+   serialized_operations.reserve( trx.operations_size() );
+   for ( const auto& op : trx.operations() )
+      serialized_operations.emplace_back( util::converter::as< std::string >( op ) );
+
+   std::size_t signatures_size = 0;
+   for ( const auto& sig : trx.signatures() )
+      signatures_size += sig.size();
+
+   concatenated_signatures.reserve( signatures_size );
+   for ( const auto& sig : trx.signatures() )
+      concatenated_signatures.append( sig );
+}
+
+prepared_block::prepared_block( const protocol::block& b ) :
+   block( &b ),
+   serialized_header( util::converter::as< std::string >( b.header() ) ),
+   byte_size( b.ByteSizeLong() )
+{
+   transactions.reserve( b.transactions_size() );
+   for ( const auto& trx : b.transactions() )
+   {
+      const auto& prepared = transactions.emplace_back( trx );
+      transactions_byte_size += prepared.byte_size;
+   }
+}
+
+} // koinos::chain
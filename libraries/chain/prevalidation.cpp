@@ -0,0 +1,187 @@
+#include <koinos/chain/exceptions.hpp>
+#include <koinos/chain/prepared_block.hpp>
+#include <koinos/chain/prevalidation.hpp>
+
+#include <koinos/crypto/elliptic.hpp>
+#include <koinos/crypto/merkle_tree.hpp>
+#include <koinos/crypto/multihash.hpp>
+
+#include <koinos/util/conversion.hpp>
+
+#include <vector>
+
+namespace koinos::chain {
+
+namespace detail {
+
+// Cache keys are built from contract supplied bytes, so every field is length prefixed. Otherwise
+// the same bytes split differently between fields would find a result computed for other inputs.
+void append_key_field( std::string& key, const std::string& field )
+{
+   key.append( util::converter::as< std::string >( uint64_t( field.size() ) ) );
+   key.append( field );
+}
+
+std::string public_key_cache_key( const std::string& signature, const std::string& digest )
+{
+   std::string key;
+   key.reserve( 2 * sizeof( uint64_t ) + signature.size() + digest.size() );
+   append_key_field( key, signature );
+   append_key_field( key, digest );
+   return key;
+}
+
+std::string hash_cache_key( uint64_t code, const std::string& data )
+{
+   auto key = util::converter::as< std::string >( code );
+   append_key_field( key, data );
+   return key;
+}
+
+std::string merkle_root_cache_key( const std::string& root, const std::vector< std::string >& hashes )
+{
+   std::size_t size = 2 * sizeof( uint64_t ) + root.size();
+   for ( const auto& h : hashes )
+      size += sizeof( uint64_t ) + h.size();
+
+   std::string key;
+   key.reserve( size );
+   append_key_field( key, root );
+   key.append( util::converter::as< std::string >( uint64_t( hashes.size() ) ) );
+   for ( const auto& h : hashes )
+      append_key_field( key, h );
+
+   return key;
+}
+
+void recover_signature( prevalidation_cache& cache, const std::string& signature, const std::string& digest )
+{
+   // Invalid signatures are left out of the cache and rejected during application
+   if ( signature.size() != 65 )
+      return;
+
+   try
+   {
+      auto recoverable_signature = util::converter::as< crypto::recoverable_signature >( signature );
+
+      if ( !crypto::public_key::is_canonical( recoverable_signature ) )
+         return;
+
+      auto pub_key = crypto::public_key::recover( recoverable_signature, util::converter::to< crypto::multihash >( digest ) );
+
+      if ( pub_key.valid() )
+         cache.insert( signature, digest, util::converter::as< std::string >( pub_key ) );
+   }
+   catch ( const std::exception& ) {}
+}
+
+} // detail
+
+void prevalidation_cache::insert( const std::string& signature, const std::string& digest, std::string public_key )
+{
+   _keys.emplace( detail::public_key_cache_key( signature, digest ), std::move( public_key ) );
+}
+
+const std::string* prevalidation_cache::find( const std::string& signature, const std::string& digest ) const
+{
+   auto itr = _keys.find( detail::public_key_cache_key( signature, digest ) );
+   return itr != _keys.end() ? &itr->second : nullptr;
+}
+
+std::size_t prevalidation_cache::size() const
+{
+   return _keys.size();
+}
+
+void prevalidation_cache::insert_hash( uint64_t code, const std::string& data, std::string digest )
+{
+   _hashes.emplace( detail::hash_cache_key( code, data ), std::move( digest ) );
+}
+
+const std::string* prevalidation_cache::find_hash( uint64_t code, const std::string& data ) const
+{
+   auto itr = _hashes.find( detail::hash_cache_key( code, data ) );
+   return itr != _hashes.end() ? &itr->second : nullptr;
+}
+
+void prevalidation_cache::insert_merkle_root( const std::string& root, const std::vector< std::string >& hashes )
+{
+   _merkle_roots.emplace( detail::merkle_root_cache_key( root, hashes ) );
+}
+
+bool prevalidation_cache::verified_merkle_root( const std::string& root, const std::vector< std::string >& hashes ) const
+{
+   return _merkle_roots.count( detail::merkle_root_cache_key( root, hashes ) );
+}
+
+std::shared_ptr< prevalidation_cache > prevalidate_block( const protocol::block& block, crypto::multicodec hash_code )
+{
+   prepared_block prepared( block );
+
+   const auto code = std::underlying_type_t< crypto::multicodec >( hash_code );
+   auto cache = std::make_shared< prevalidation_cache >();
+
+   auto hash = [&]( const std::string& data )
+   {
+      auto digest = util::converter::as< std::string >( crypto::hash( hash_code, data ) );
+      cache->insert_hash( code, data, digest );
+      return digest;
+   };
+
+   auto verify_merkle_root = [&]( const std::string& root, const std::vector< std::string >& hashes )
+   {
+      std::vector< crypto::multihash > leaves;
+      leaves.reserve( hashes.size() );
+
+      for ( const auto& h : hashes )
+         leaves.emplace_back( util::converter::to< crypto::multihash >( h ) );
+
+      if ( crypto::merkle_tree( hash_code, leaves ).root()->hash() != util::converter::to< crypto::multihash >( root ) )
+         return false;
+
+      cache->insert_merkle_root( root, hashes );
+      return true;
+   };
+
+   KOINOS_ASSERT( hash( prepared.serialized_header ) == block.id(), block_id_mismatch, "block contains an invalid block id" );
+
+   const auto tx_root = util::converter::to< crypto::multihash >( block.header().transaction_merkle_root() );
+   KOINOS_ASSERT( tx_root.code() == hash_code, hash_code_mismatch, "unexpected transaction merkle root hash code" );
+
+   std::vector< std::string > trx_hashes;
+   trx_hashes.reserve( prepared.transactions.size() * 2 );
+
+   for ( const auto& trx : prepared.transactions )
+   {
+      const auto& tx = *trx.transaction;
+
+      auto header_hash = hash( trx.serialized_header );
+      KOINOS_ASSERT( header_hash == tx.id(), transaction_id_mismatch, "transaction contains an invalid transaction id" );
+
+      trx_hashes.emplace_back( std::move( header_hash ) );
+      trx_hashes.emplace_back( hash( trx.concatenated_signatures ) );
+
+      const auto op_root = util::converter::to< crypto::multihash >( tx.header().operation_merkle_root() );
+      KOINOS_ASSERT( op_root.code() == hash_code, hash_code_mismatch, "unexpected operation merkle root hash code" );
+
+      std::vector< std::string > op_hashes;
+      op_hashes.reserve( trx.serialized_operations.size() );
+
+      for ( const auto& op : trx.serialized_operations )
+         op_hashes.emplace_back( hash( op ) );
+
+      KOINOS_ASSERT( verify_merkle_root( tx.header().operation_merkle_root(), op_hashes ), operation_root_mismatch, "operation merkle root does not match" );
+
+      for ( const auto& sig : tx.signatures() )
+         detail::recover_signature( *cache, sig, tx.id() );
+   }
+
+   KOINOS_ASSERT( verify_merkle_root( block.header().transaction_merkle_root(), trx_hashes ), transaction_root_mismatch, "transaction merkle root does not match" );
+
+   // The block signature is recovered over the hash of the header, which is the block id
+   detail::recover_signature( *cache, block.signature(), block.id() );
+
+   return cache;
+}
+
+} // koinos::chain
@@ -2,12 +2,21 @@
 #include <koinos/chain/session.hpp>
 #include <koinos/chain/exceptions.hpp>
 
-#include <boost/multiprecision/cpp_int.hpp>
-
-using uint128_t = boost::multiprecision::uint128_t;
+#include <limits>
 
 namespace koinos::chain {
 
+namespace {
+
+uint64_t rc_cost( uint64_t amount, uint64_t cost )
+{
+   uint64_t rc;
+   KOINOS_ASSERT( !__builtin_mul_overflow( amount, cost, &rc ), insufficient_rc, "rc overflow" );
+   return rc;
+}
+
+} // anonymous
+
 /*
  * Resource meter
  */
@@ -31,17 +40,17 @@ void resource_meter::set_resource_limit_data( const resource_limit_data& rld )
    _disk_storage_remaining      = _resource_limit_data.disk_storage_limit();
    _network_bandwidth_remaining = _resource_limit_data.network_bandwidth_limit();
    _compute_bandwidth_remaining = _resource_limit_data.compute_bandwidth_limit();
+   _session_compute_valid       = false;
 }
 
 void resource_meter::use_disk_storage( uint64_t bytes )
 {
    KOINOS_ASSERT( bytes <= _disk_storage_remaining, disk_storage_limit_exceeded, "disk storage limit exceeded" );
 
-   if ( auto session = _session.lock() )
+   if ( auto s = session() )
    {
-      uint128_t rc_cost = uint128_t( bytes ) * _resource_limit_data.disk_storage_cost();
-      KOINOS_ASSERT( rc_cost <= std::numeric_limits< uint64_t >::max(), insufficient_rc, "rc overflow" );
-      session->use_rc( rc_cost.convert_to< uint64_t >() );
+      s->use_rc( rc_cost( bytes, _resource_limit_data.disk_storage_cost() ) );
+      _session_compute_valid = false;
    }
 
    _disk_storage_remaining -= bytes;
@@ -54,12 +63,12 @@ uint64_t resource_meter::disk_storage_used()
 
 uint64_t resource_meter::disk_storage_remaining()
 {
-   if ( auto session = _session.lock() )
+   if ( auto s = session() )
    {
       auto cost = _resource_limit_data.disk_storage_cost();
 
       if ( cost > 0 )
-         return session->remaining_rc() / cost;
+         return s->remaining_rc() / cost;
       else
          return std::numeric_limits< uint64_t >::max();
    }
@@ -71,11 +80,10 @@ void resource_meter::use_network_bandwidth( uint64_t bytes )
 {
    KOINOS_ASSERT( bytes <= _network_bandwidth_remaining, network_bandwidth_limit_exceeded, "network bandwidth limit exceeded" );
 
-   if ( auto session = _session.lock() )
+   if ( auto s = session() )
    {
-      uint128_t rc_cost = uint128_t( bytes ) * _resource_limit_data.network_bandwidth_cost();
-      KOINOS_ASSERT( rc_cost <= std::numeric_limits< uint64_t >::max(), insufficient_rc, "rc overflow" );
-      session->use_rc( rc_cost.convert_to< uint64_t >() );
+      s->use_rc( rc_cost( bytes, _resource_limit_data.network_bandwidth_cost() ) );
+      _session_compute_valid = false;
    }
 
    _network_bandwidth_remaining -= bytes;
@@ -88,12 +96,12 @@ uint64_t resource_meter::network_bandwidth_used()
 
 uint64_t resource_meter::network_bandwidth_remaining()
 {
-   if ( auto session = _session.lock() )
+   if ( auto s = session() )
    {
       auto cost = _resource_limit_data.network_bandwidth_cost();
 
       if ( cost > 0 )
-         return session->remaining_rc() / cost;
+         return s->remaining_rc() / cost;
       else
          return std::numeric_limits< uint64_t >::max();
    }
@@ -105,11 +113,13 @@ void resource_meter::use_compute_bandwidth( uint64_t ticks )
 {
    KOINOS_ASSERT( ticks <= _compute_bandwidth_remaining, compute_bandwidth_limit_exceeded, "compute bandwidth limit exceeded" );
 
-   if ( auto session = _session.lock() )
+   if ( auto s = session() )
    {
-      uint128_t rc_cost = uint128_t( ticks ) * _resource_limit_data.compute_bandwidth_cost();
-      KOINOS_ASSERT( rc_cost <= std::numeric_limits< uint64_t >::max(), insufficient_rc, "rc overflow" );
-      session->use_rc( rc_cost.convert_to< uint64_t >() );
+      s->use_rc( rc_cost( ticks, _resource_limit_data.compute_bandwidth_cost() ) );
+
+      // The session paid exactly ticks times the cost, so it can pay for exactly ticks fewer
+      if ( _session_compute_valid && _session_compute_remaining != std::numeric_limits< uint64_t >::max() )
+         _session_compute_remaining -= ticks;
    }
 
    _compute_bandwidth_remaining -= ticks;
@@ -122,14 +132,21 @@ uint64_t resource_meter::compute_bandwidth_used()
 
 uint64_t resource_meter::compute_bandwidth_remaining()
 {
-   if ( auto session = _session.lock() )
+   if ( auto s = session() )
    {
-      auto cost = _resource_limit_data.compute_bandwidth_cost();
+      if ( !_session_compute_valid )
+      {
+         auto cost = _resource_limit_data.compute_bandwidth_cost();
 
-      if ( cost > 0 )
-         return session->remaining_rc() / cost;
-      else
-         return std::numeric_limits< uint64_t >::max();
+         if ( cost > 0 )
+            _session_compute_remaining = s->remaining_rc() / cost;
+         else
+            _session_compute_remaining = std::numeric_limits< uint64_t >::max();
+
+         _session_compute_valid = true;
+      }
+
+      return _session_compute_remaining;
    }
 
    return _compute_bandwidth_remaining;
@@ -137,7 +154,15 @@ uint64_t resource_meter::compute_bandwidth_remaining()
 
 void resource_meter::set_session( std::shared_ptr< abstract_rc_session > s )
 {
-   _session = s;
+   _session               = s;
+   _session_ptr           = s.get();
+   _session_compute_valid = false;
+}
+
+abstract_rc_session* resource_meter::session() const
+{
+   // Meters are used from a single thread, a session that has not expired stays alive while it is charged
+   return _session.expired() ? nullptr : _session_ptr;
 }
 
 } // koinos::chain
@@ -131,6 +131,24 @@ void assert_permissions( execution_context& context, const object_space& space )
    }
 }
 
+bool is_cached_object( const object_space& space, const std::string& key )
+{
+   if ( !space.system() || space.zone() != zone::kernel )
+      return false;
+
+   switch ( space.id() )
+   {
+      case system_space_id::contract_bytecode:
+      case system_space_id::contract_metadata:
+      case system_space_id::system_call_dispatch:
+         return true;
+      case system_space_id::metadata:
+         return key == key::protocol_descriptor || key == key::compute_bandwidth_registry || key == key::block_hash_code;
+      default:
+         return false;
+   }
+}
+
 } // state
 
 } // koinos::chain
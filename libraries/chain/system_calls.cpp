@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <optional>
 #include <string>
 #include <stdexcept>
 
@@ -8,6 +9,7 @@
 #include <koinos/chain/execution_context.hpp>
 #include <koinos/chain/constants.hpp>
 #include <koinos/chain/host_api.hpp>
+#include <koinos/chain/prepared_block.hpp>
 #include <koinos/chain/proto_utils.hpp>
 #include <koinos/chain/state.hpp>
 #include <koinos/chain/system_calls.hpp>
@@ -126,6 +128,24 @@ struct transaction_guard
    execution_context& ctx;
 };
 
+// RAII class to expose the prepared form of a transaction to apply_transaction only for the
+// duration of its application.
+struct prepared_transaction_guard
+{
+   prepared_transaction_guard( execution_context& context, const prepared_transaction& trx ) :
+      ctx( context )
+   {
+      ctx.set_prepared_transaction( &trx );
+   }
+
+   ~prepared_transaction_guard()
+   {
+      ctx.set_prepared_transaction( nullptr );
+   }
+
+   execution_context& ctx;
+};
+
 void validate_hash_code( crypto::multicodec id )
 {
    switch ( id )
@@ -157,7 +177,8 @@ THUNK_DEFINE( void, exit_contract, ((uint32_t) exit_code) )
    switch( exit_code )
    {
       case exit_code::success:
-          KOINOS_THROW( exit_success, "" );
+          context.request_exit();
+          break;
       case exit_code::failure:
           KOINOS_THROW( exit_failure, "" );
       default:
@@ -167,9 +188,23 @@ THUNK_DEFINE( void, exit_contract, ((uint32_t) exit_code) )
 
 THUNK_DEFINE( process_block_signature_result, process_block_signature, ((const std::string&) id, (const protocol::block_header&) header, (const std::string&) signature_data) )
 {
-   auto genesis_addr = system_call::get_object( context, state::space::metadata(), state::key::genesis_key ).value();
+   std::string buffer;
+   auto genesis_object = system_call::get_object_view( context, state::space::metadata(), state::key::genesis_key, buffer );
+   const auto& genesis_addr = genesis_object ? *genesis_object : buffer;
 
    process_block_signature_result ret;
+
+   // Trusted blocks are verified by hash linkage to the trusted checkpoint. The recovery is
+   // charged exactly as the native recover_public_key would be, so resource usage is unchanged.
+   if ( context.trusted_block()
+     && !context.system_call_exists( system_call_id::recover_public_key )
+     && context.thunk_translation( system_call_id::recover_public_key ) == system_call_id::recover_public_key )
+   {
+      context.resource_meter().use_compute_bandwidth( context.get_compute_bandwidth( system_call_id::recover_public_key ) );
+      ret.set_value( true );
+      return ret;
+   }
+
    ret.set_value( genesis_addr == util::converter::to< crypto::public_key >( system_call::recover_public_key( context, ecdsa_secp256k1, signature_data, id ) ).to_address_bytes() );
    return ret;
 }
@@ -179,6 +214,15 @@ THUNK_DEFINE( verify_merkle_root_result, verify_merkle_root, ((const std::string
    auto root_hash = util::converter::to< crypto::multihash >( root );
    validate_hash_code( root_hash.code() );
 
+   verify_merkle_root_result ret;
+
+   // Merkle roots verified during block prevalidation match their leaves
+   if ( auto cache = context.get_prevalidation_cache(); cache && cache->verified_merkle_root( root, hashes ) )
+   {
+      ret.set_value( true );
+      return ret;
+   }
+
    std::vector< crypto::multihash > leaves;
 
    leaves.resize( hashes.size() );
@@ -188,7 +232,6 @@ THUNK_DEFINE( verify_merkle_root_result, verify_merkle_root, ((const std::string
 
    auto merkle_root = mtree.root()->hash();
 
-   verify_merkle_root_result ret;
    ret.set_value( merkle_root == root_hash );
    return ret;
 }
@@ -208,8 +251,12 @@ THUNK_DEFINE( void, apply_block, ((const protocol::block&) block) )
 
    context.resource_meter().set_resource_limit_data( system_call::get_resource_limits( context ) );
 
+   const auto hash_code = std::underlying_type_t< crypto::multicodec >( context.block_hash_code() );
+
+   prepared_block prepared( block );
+
    KOINOS_ASSERT(
-      system_call::hash( context, std::underlying_type_t< crypto::multicodec >( context.block_hash_code() ), util::converter::as< std::string >( block.header() ) ) == block.id(),
+      system_call::hash( context, hash_code, prepared.serialized_header ) == block.id(),
       block_id_mismatch,
       "block contains an invalid block id"
    );
@@ -224,28 +271,19 @@ THUNK_DEFINE( void, apply_block, ((const protocol::block&) block) )
 
    // Check transaction Merkle root
    std::vector< std::string > hashes;
-   hashes.reserve( block.transactions_size() * 2 );
+   hashes.reserve( prepared.transactions.size() * 2 );
 
-   std::size_t transactions_bytes_size = 0;
-   for ( const auto& trx : block.transactions() )
+   for ( const auto& trx : prepared.transactions )
    {
-      transactions_bytes_size += trx.ByteSizeLong();
-      hashes.emplace_back( system_call::hash( context, std::underlying_type_t< crypto::multicodec >( context.block_hash_code() ), util::converter::as< std::string >( trx.header() ) ) );
-      std::stringstream ss;
-
-      for ( const auto& sig : trx.signatures() )
-      {
-         ss << sig;
-      }
-
-      hashes.emplace_back( system_call::hash( context, std::underlying_type_t< crypto::multicodec >( context.block_hash_code() ), ss.str() ) );
+      hashes.emplace_back( system_call::hash( context, hash_code, trx.serialized_header ) );
+      hashes.emplace_back( system_call::hash( context, hash_code, trx.concatenated_signatures ) );
    }
 
-   context.resource_meter().use_network_bandwidth( block.ByteSizeLong() - transactions_bytes_size );
+   context.resource_meter().use_network_bandwidth( prepared.byte_size - prepared.transactions_byte_size );
 
    KOINOS_ASSERT( system_call::verify_merkle_root( context, block.header().transaction_merkle_root(), hashes ), transaction_root_mismatch, "transaction merkle root does not match" );
 
-   auto block_hash = util::converter::to< crypto::multihash >( system_call::hash( context, std::underlying_type_t< crypto::multicodec >( context.block_hash_code() ), util::converter::as< std::string >( block.header() ) ) );
+   auto block_hash = util::converter::to< crypto::multihash >( system_call::hash( context, hash_code, prepared.serialized_header ) );
    KOINOS_ASSERT(
       system_call::process_block_signature(
          context,
@@ -261,10 +299,13 @@ THUNK_DEFINE( void, apply_block, ((const protocol::block&) block) )
 
    system_call::put_object( context, state::space::metadata(), state::key::head_block_time, util::converter::as< std::string >( block.header().timestamp() ) );
 
-   for ( const auto& tx : block.transactions() )
+   for ( const auto& trx : prepared.transactions )
    {
+      const auto& tx = *trx.transaction;
+
       try
       {
+         prepared_transaction_guard prepared_guard( context, trx );
          system_call::apply_transaction( context, tx );
       }
       catch( const transaction_reverted& ) {} /* do nothing */
@@ -323,12 +364,21 @@ THUNK_DEFINE( void, apply_transaction, ((const protocol::transaction&) trx) )
     */
    auto payer_session = context.make_session( trx.header().rc_limit() );
 
-   auto chain_id = system_call::get_object( context, state::space::metadata(), state::key::chain_id );
-   KOINOS_ASSERT( chain_id.exists(), unexpected_state, "chain id does not exist" );
-   KOINOS_ASSERT( trx.header().chain_id() == chain_id.value(), chain_id_mismatch, "chain id mismatch" );
+   std::string chain_id_buffer;
+   auto chain_id = system_call::get_object_view( context, state::space::metadata(), state::key::chain_id, chain_id_buffer );
+   KOINOS_ASSERT( chain_id, unexpected_state, "chain id does not exist" );
+   KOINOS_ASSERT( trx.header().chain_id() == *chain_id, chain_id_mismatch, "chain id mismatch" );
+
+   const auto hash_code = std::underlying_type_t< crypto::multicodec >( context.block_hash_code() );
+
+   // Use the prepared transaction from apply_block when available, otherwise prepare it here
+   std::optional< prepared_transaction > local_prepared;
+   const prepared_transaction* prepared = context.get_prepared_transaction();
+   if ( !prepared || prepared->transaction != &trx )
+      prepared = &local_prepared.emplace( trx );
 
    KOINOS_ASSERT(
-      system_call::hash( context, std::underlying_type_t< crypto::multicodec >( context.block_hash_code() ), util::converter::as< std::string >( trx.header() ) ) == trx.id(),
+      system_call::hash( context, hash_code, prepared->serialized_header ) == trx.id(),
       transaction_id_mismatch,
       "transaction contains an invalid transaction id"
    );
@@ -343,10 +393,10 @@ THUNK_DEFINE( void, apply_transaction, ((const protocol::transaction&) trx) )
 
    // Check operation merkle root
    std::vector< std::string > hashes;
-   hashes.reserve( trx.operations_size() );
+   hashes.reserve( prepared->serialized_operations.size() );
 
-   for ( const auto& op : trx.operations() )
-      hashes.emplace_back( system_call::hash( context, std::underlying_type_t< crypto::multicodec >( context.block_hash_code() ), util::converter::as< std::string >( op ) ) );
+   for ( const auto& op : prepared->serialized_operations )
+      hashes.emplace_back( system_call::hash( context, hash_code, op ) );
 
    KOINOS_ASSERT( system_call::verify_merkle_root( context, trx.header().operation_merkle_root(), hashes ), operation_root_mismatch, "operation merkle root does not match" );
 
@@ -380,7 +430,7 @@ THUNK_DEFINE( void, apply_transaction, ((const protocol::transaction&) trx) )
    auto trx_node = block_node->create_anonymous_node();
    context.set_state_node( trx_node, block_node->get_parent() );
 
-   std::exception_ptr reverted_exception_ptr;
+   std::string revert_reason;
 
    receipt.set_id( trx.id() );
    receipt.set_payer( payer );
@@ -390,7 +440,7 @@ THUNK_DEFINE( void, apply_transaction, ((const protocol::transaction&) trx) )
 
    try
    {
-      context.resource_meter().use_network_bandwidth( trx.ByteSizeLong() );
+      context.resource_meter().use_network_bandwidth( prepared->byte_size );
 
       for ( const auto& o : trx.operations() )
       {
@@ -418,8 +468,7 @@ THUNK_DEFINE( void, apply_transaction, ((const protocol::transaction&) trx) )
       // If the transaction fails for any other reason within the operations, it is reverted.
       // Mana is still charged, but the block does not fail
       LOG(info) << "Transaction " << util::to_hex( trx.id() ) << " reverted with: " << e.what();
-      transaction_reverted tr( e.what() );
-      reverted_exception_ptr = std::make_exception_ptr( tr );
+      revert_reason = e.what();
       receipt.set_reverted( true );
    }
 
@@ -464,9 +513,10 @@ THUNK_DEFINE( void, apply_transaction, ((const protocol::transaction&) trx) )
       break;
    }
 
-   if ( reverted_exception_ptr )
+   // A block records the revert in the transaction receipt, only a submitted transaction fails with it
+   if ( receipt.reverted() && context.intent() == intent::transaction_application )
    {
-      std::rethrow_exception( reverted_exception_ptr );
+      throw transaction_reverted( revert_reason );
    }
 }
 
@@ -485,6 +535,8 @@ THUNK_DEFINE( void, apply_upload_contract_operation, ((const protocol::upload_co
 
    system_call::put_object( context, state::space::contract_bytecode(), o.contract_id(), o.bytecode() );
    system_call::put_object( context, state::space::contract_metadata(), o.contract_id(), util::converter::as< std::string >( contract_meta ) );
+
+   context.add_uploaded_contract( contract_meta.hash(), o.bytecode() );
 }
 
 THUNK_DEFINE( void, apply_call_contract_operation, ((const protocol::call_contract_operation&) o) )
@@ -561,9 +613,13 @@ THUNK_DEFINE( put_object_result, put_object, ((const object_space&) space, (cons
 
    auto state = context.get_state_node();
    KOINOS_ASSERT( state, state_node_not_found, "current state node does not exist" );
-   auto val = util::converter::as< state_db::object_value >( obj );
+   auto bytes_used = state->put_object( space, key, state_db::object_value( obj ) );
 
-   auto bytes_used = state->put_object( space, key, &val );
+   if ( state::is_cached_object( space, key ) )
+      context.mark_cache_dirty();
+
+   if ( space.system() && space.zone() == state::zone::kernel )
+      context.evict_decoded_object( space.id(), key );
 
    if ( bytes_used > 0 )
       context.resource_meter().use_disk_storage( bytes_used );
@@ -584,6 +640,12 @@ THUNK_DEFINE( void, remove_object, ((const object_space&) space, (const std::str
    KOINOS_ASSERT( state, state_node_not_found, "current state node does not exist" );
 
    state->remove_object( space, key );
+
+   if ( state::is_cached_object( space, key ) )
+      context.mark_cache_dirty();
+
+   if ( space.system() && space.zone() == state::zone::kernel )
+      context.evict_decoded_object( space.id(), key );
 }
 
 THUNK_DEFINE( get_object_result, get_object, ((const object_space&) space, (const std::string&) key) )
@@ -652,33 +714,38 @@ THUNK_DEFINE( get_prev_object_result, get_prev_object, ((const object_space&) sp
 THUNK_DEFINE( call_contract_result, call_contract, ((const std::string&) contract_id, (uint32_t) entry_point, (const std::string&) args) )
 {
    // We need to be in kernel mode to read the contract data
-   auto contract_object = system_call::get_object( context, state::space::contract_bytecode(), contract_id );
-   KOINOS_ASSERT( contract_object.exists(), invalid_contract, "contract does not exist" );
-   auto contract_meta_object = system_call::get_object( context, state::space::contract_metadata(), contract_id );
-   KOINOS_ASSERT( contract_meta_object.exists(), invalid_contract, "contract metadata does not exist" );
-   auto contract_meta = util::converter::to< contract_metadata_object >( contract_meta_object.value() );
+   std::string bytecode_buffer, meta_buffer;
+   auto contract_bytecode = system_call::get_object_view( context, state::space::contract_bytecode(), contract_id, bytecode_buffer );
+   KOINOS_ASSERT( contract_bytecode, invalid_contract, "contract does not exist" );
+   auto contract_meta_object = system_call::get_object_view( context, state::space::contract_metadata(), contract_id, meta_buffer );
+   KOINOS_ASSERT( contract_meta_object, invalid_contract, "contract metadata does not exist" );
+   auto contract_meta = util::converter::to< contract_metadata_object >( *contract_meta_object );
    KOINOS_ASSERT( contract_meta.hash().size(), invalid_contract, "contract hash does not exist" );
 
+   call_contract_result ret;
    context.push_frame( stack_frame{
       .contract_id = contract_id,
       .call_privilege = contract_meta.system() ? privilege::kernel_mode : privilege::user_mode,
       .call_args = args,
-      .entry_point = entry_point
+      .entry_point = entry_point,
+      .call_return = ret.mutable_value()
    } );
 
+   context.clear_exit();
+
    try
    {
       chain::host_api hapi( context );
-      context.get_backend()->run( hapi, contract_object.value(), contract_meta.hash() );
+      context.get_backend()->run( hapi, *contract_bytecode, contract_meta.hash() );
    }
-   catch( const exit_success& ) {}
    catch( ... ) {
+      context.clear_exit();
       context.pop_frame();
       throw;
    }
 
-   call_contract_result ret;
-   ret.set_value( context.pop_frame().call_return );
+   context.clear_exit();
+   context.pop_frame();
    return ret;
 }
 
@@ -692,7 +759,8 @@ THUNK_DEFINE_VOID( get_entry_point_result, get_entry_point )
 THUNK_DEFINE_VOID( get_contract_arguments_result, get_contract_arguments )
 {
    get_contract_arguments_result ret;
-   ret.set_value( context.get_contract_call_args() );
+   auto args = context.get_contract_call_args();
+   ret.set_value( args.data(), args.size() );
    return ret;
 }
 
@@ -733,9 +801,20 @@ THUNK_DEFINE( hash_result, hash, ((uint64_t) id, (const std::string&) obj, (uint
    auto multicodec = static_cast< crypto::multicodec >( id );
    validate_hash_code( multicodec );
 
+   hash_result ret;
+
+   // Digests computed during block prevalidation use the default digest size
+   if ( auto cache = context.get_prevalidation_cache(); cache && !size )
+   {
+      if ( auto digest = cache->find_hash( id, obj ); digest )
+      {
+         ret.set_value( *digest );
+         return ret;
+      }
+   }
+
    auto hash = crypto::hash( multicodec, obj, crypto::digest_size( size ) );
 
-   hash_result ret;
    ret.set_value( util::converter::as< std::string >( hash ) );
    return ret;
 }
@@ -745,6 +824,19 @@ THUNK_DEFINE( recover_public_key_result, recover_public_key, ((dsa) type, (const
    KOINOS_ASSERT( type == ecdsa_secp256k1, invalid_dsa, "unexpected dsa" );
 
    KOINOS_ASSERT( signature_data.size() == 65, invalid_signature, "unexpected signature length" );
+
+   recover_public_key_result ret;
+
+   // Public keys recovered during block prevalidation only come from valid, canonical signatures
+   if ( auto cache = context.get_prevalidation_cache(); cache )
+   {
+      if ( auto pub_key = cache->find( signature_data, digest ); pub_key )
+      {
+         ret.set_value( *pub_key );
+         return ret;
+      }
+   }
+
    crypto::recoverable_signature signature = util::converter::as< crypto::recoverable_signature >( signature_data );
 
    KOINOS_ASSERT( crypto::public_key::is_canonical( signature ), invalid_signature, "signature must be canonical" );
@@ -752,7 +844,6 @@ THUNK_DEFINE( recover_public_key_result, recover_public_key, ((dsa) type, (const
    auto pub_key = crypto::public_key::recover( signature, util::converter::to< crypto::multihash >( digest ) );
    KOINOS_ASSERT( pub_key.valid(), invalid_signature, "public key is invalid" );
 
-   recover_public_key_result ret;
    ret.set_value( util::converter::as< std::string >( pub_key ) );
    return ret;
 }
@@ -770,27 +861,10 @@ THUNK_DEFINE_VOID( get_last_irreversible_block_result, get_last_irreversible_blo
 THUNK_DEFINE_VOID( get_caller_result, get_caller )
 {
    get_caller_result ret;
-   auto frame0 = context.pop_frame(); // get_caller frame
-   auto frame1 = context.pop_frame(); // contract frame
-   std::exception_ptr e;
-
-   try
-   {
-      ret.mutable_value()->set_caller( context.get_caller() );
-      ret.mutable_value()->set_caller_privilege( context.get_caller_privilege() );
-   }
-   catch( ... )
-   {
-      e = std::current_exception();
-   }
-
-   context.push_frame( std::move( frame1 ) );
-   context.push_frame( std::move( frame0 ) );
 
-   if ( e )
-   {
-      std::rethrow_exception( e );
-   }
+   // Skip the get_caller frame and the calling contract's frame
+   ret.mutable_value()->set_caller( context.get_caller( 2 ) );
+   ret.mutable_value()->set_caller_privilege( context.get_caller_privilege( 2 ) );
    return ret;
 }
 
@@ -798,12 +872,13 @@ THUNK_DEFINE( void, require_authority, ((authorization_type) type, (const std::s
 {
    KOINOS_ASSERT( !context.read_only(), read_only_context, "unable to perform action while context is read only" );
 
-   auto account_contract_meta_object = system_call::get_object( context, state::space::contract_metadata(), account );
+   std::string buffer;
+   auto account_contract_meta_object = system_call::get_object_view( context, state::space::contract_metadata(), account, buffer );
    bool authorize_override = false;
 
-   if ( account_contract_meta_object.exists() )
+   if ( account_contract_meta_object )
    {
-      auto account_contract_meta = util::converter::to< contract_metadata_object >( account_contract_meta_object.value() );
+      auto account_contract_meta = util::converter::to< contract_metadata_object >( *account_contract_meta_object );
 
       switch ( type )
       {
@@ -860,13 +935,14 @@ THUNK_DEFINE_VOID( get_contract_id_result, get_contract_id )
 
 THUNK_DEFINE( get_account_nonce_result, get_account_nonce, ((const std::string&) account ) )
 {
-   auto obj = system_call::get_object( context, state::space::transaction_nonce(), account );
+   std::string buffer;
+   auto obj = system_call::get_object_view( context, state::space::transaction_nonce(), account, buffer );
 
    get_account_nonce_result ret;
 
-   if ( obj.exists() )
+   if ( obj )
    {
-      ret.set_value( obj.value() );
+      ret.set_value( *obj );
    }
    else
    {
@@ -915,11 +991,11 @@ THUNK_DEFINE( void, set_account_nonce, ((const std::string&) account, (const std
 
 THUNK_DEFINE( get_account_rc_result, get_account_rc, ((const std::string&) account) )
 {
-   auto obj = system_call::get_object( context, state::space::metadata(), state::key::max_account_resources );
-   KOINOS_ASSERT( obj.exists(), unexpected_state, "max_account_resources does not exist" );
+   auto obj = system_call::get_decoded_object< chain::max_account_resources >( context, state::space::metadata(), state::key::max_account_resources );
+   KOINOS_ASSERT( obj, unexpected_state, "max_account_resources does not exist" );
 
    get_account_rc_result ret;
-   ret.set_value( util::converter::to< chain::max_account_resources >( obj.value() ).value() );
+   ret.set_value( obj->value() );
 
    return ret;
 }
@@ -933,13 +1009,11 @@ THUNK_DEFINE( consume_account_rc_result, consume_account_rc, ((const std::string
 
 THUNK_DEFINE_VOID( get_resource_limits_result, get_resource_limits )
 {
-   resource_limit_data rd;
-
-   auto obj = system_call::get_object( context, state::space::metadata(), state::key::resource_limit_data );
-   KOINOS_ASSERT( obj.exists(), unexpected_state, "resource_limit_data does not exist" );
+   auto obj = system_call::get_decoded_object< resource_limit_data >( context, state::space::metadata(), state::key::resource_limit_data );
+   KOINOS_ASSERT( obj, unexpected_state, "resource_limit_data does not exist" );
 
    get_resource_limits_result ret;
-   *ret.mutable_value() = util::converter::to< resource_limit_data >( obj.value() );
+   *ret.mutable_value() = *obj;
    return ret;
 }
 
@@ -1011,7 +1085,9 @@ THUNK_DEFINE( get_block_field_result, get_block_field, ((const std::string&) fie
 
 THUNK_DEFINE( void, require_system_authority, ((system_authorization_type) type) )
 {
-   auto genesis_addr = system_call::get_object( context, state::space::metadata(), state::key::genesis_key ).value();
+   std::string buffer;
+   auto genesis_object = system_call::get_object_view( context, state::space::metadata(), state::key::genesis_key, buffer );
+   const auto& genesis_addr = genesis_object ? *genesis_object : buffer;
 
    const auto& trx = context.get_transaction();
 
@@ -1039,4 +1115,103 @@ THUNK_DEFINE( verify_signature_result, verify_signature, ((dsa) type, (const std
 
 THUNK_DEFINE_END();
 
+namespace system_call {
+
+const std::string* get_object_view( execution_context& context, const object_space& space, const std::string& key, std::string& buffer )
+{
+   uint32_t sid = static_cast< uint32_t >( system_call_id::get_object );
+
+   if ( context.system_call_exists( sid ) || context.thunk_translation( sid ) != sid )
+   {
+      auto obj = system_call::get_object( context, space, key );
+
+      if ( !obj.exists() )
+         return nullptr;
+
+      buffer = obj.value();
+      return &buffer;
+   }
+
+   const std::string* result = nullptr;
+
+   with_stack_frame(
+      context,
+      stack_frame {
+         .sid = sid,
+         .call_privilege = privilege::kernel_mode
+      },
+      [&]() {
+         context.resource_meter().use_compute_bandwidth( context.get_compute_bandwidth( sid ) );
+
+         state::assert_permissions( context, space );
+
+         abstract_state_node_ptr state = context.get_state_node();
+
+         KOINOS_ASSERT( state, state_node_not_found, "current state node does not exist" );
+
+         // The value in state may be owned by the object cache and freed by any later read, so it is
+         // copied out while it is known to be alive
+         if ( auto obj = state->get_object( space, key ); obj )
+         {
+            buffer = *obj;
+            result = &buffer;
+         }
+      }
+   );
+
+   return result;
+}
+
+std::shared_ptr< const google::protobuf::Message > get_decoded_object( execution_context& context, const object_space& space, const std::string& key, const google::protobuf::Message& prototype )
+{
+   uint32_t sid = static_cast< uint32_t >( system_call_id::get_object );
+
+   auto decode = [&]( const std::string& bytes ) -> std::shared_ptr< const google::protobuf::Message >
+   {
+      std::shared_ptr< google::protobuf::Message > object( prototype.New() );
+      KOINOS_ASSERT( object->ParseFromString( bytes ), unexpected_state, "unable to decode ${t}", ("t", prototype.GetTypeName()) );
+      return object;
+   };
+
+   if ( !space.system() || space.zone() != state::zone::kernel || context.system_call_exists( sid ) || context.thunk_translation( sid ) != sid )
+   {
+      std::string buffer;
+      auto obj = get_object_view( context, space, key, buffer );
+      return obj ? decode( *obj ) : nullptr;
+   }
+
+   std::shared_ptr< const google::protobuf::Message > result;
+
+   with_stack_frame(
+      context,
+      stack_frame {
+         .sid = sid,
+         .call_privilege = privilege::kernel_mode
+      },
+      [&]() {
+         context.resource_meter().use_compute_bandwidth( context.get_compute_bandwidth( sid ) );
+
+         state::assert_permissions( context, space );
+
+         result = context.get_decoded_object( space.id(), key );
+         if ( result && result->GetDescriptor() == prototype.GetDescriptor() )
+            return;
+
+         abstract_state_node_ptr state = context.get_state_node();
+
+         KOINOS_ASSERT( state, state_node_not_found, "current state node does not exist" );
+
+         auto obj = state->get_object( space, key );
+         result = obj ? decode( *obj ) : nullptr;
+
+         if ( result )
+            context.set_decoded_object( space.id(), key, result );
+      }
+   );
+
+   return result;
+}
+
+} // system_call
+
 } // koinos::chain
@@ -15,15 +15,13 @@ const thunk_dispatcher& thunk_dispatcher::instance()
 
 uint32_t thunk_dispatcher::call_thunk( uint32_t id, execution_context& ctx, char* ret_ptr, uint32_t ret_len, const char* arg_ptr, uint32_t arg_len )const
 {
-   auto it = _dispatch_map.find( id );
-   KOINOS_ASSERT( it != _dispatch_map.end(), thunk_not_found, "thunk ${id} not found", ("id", id) );
-   return it->second( ctx, ret_ptr, ret_len, arg_ptr, arg_len );
+   const auto& entry = get_entry( id );
+   return entry.handler( entry.thunk, ctx, ret_ptr, ret_len, arg_ptr, arg_len );
 }
 
 bool thunk_dispatcher::thunk_exists( uint32_t id ) const
 {
-   auto it = _dispatch_map.find( id );
-   return it != _dispatch_map.end();
+   return id < _thunks.size() && _thunks[ id ].handler;
 }
 
 } // koinos::chain
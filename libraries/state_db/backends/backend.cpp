@@ -7,4 +7,17 @@ bool abstract_backend::empty() const
    return size() == 0;
 }
 
+std::vector< std::optional< abstract_backend::value_type > > abstract_backend::multi_get( const std::vector< key_type >& keys ) const
+{
+   std::vector< std::optional< value_type > > values( keys.size() );
+
+   for ( std::size_t i = 0; i < keys.size(); i++ )
+   {
+      if ( auto ptr = get( keys[ i ] ); ptr )
+         values[ i ] = *ptr;
+   }
+
+   return values;
+}
+
 } // koinos::state_db::backends
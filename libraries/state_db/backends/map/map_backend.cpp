@@ -16,9 +16,16 @@ iterator map_backend::end() noexcept
    return iterator( std::make_unique< map_iterator >( std::make_unique< map_iterator::iterator_impl >( _map.end() ), _map ) );
 }
 
-void map_backend::put( const key_type& k, const value_type& v )
+std::optional< map_backend::size_type > map_backend::put( const key_type& k, value_type&& v )
 {
-   _map.insert_or_assign( k, v );
+   // try_emplace leaves v untouched when the key exists
+   auto [ itr, inserted ] = _map.try_emplace( k, std::move( v ) );
+   if ( inserted )
+      return {};
+
+   size_type previous = itr->second.size();
+   itr->second = std::move( v );
+   return previous;
 }
 
 const map_backend::value_type* map_backend::get( const key_type& key ) const
@@ -32,9 +39,15 @@ const map_backend::value_type* map_backend::get( const key_type& key ) const
    return &itr->second;
 }
 
-void map_backend::erase( const key_type& k )
+std::optional< map_backend::size_type > map_backend::erase( const key_type& k )
 {
-   _map.erase( k );
+   auto itr = _map.find( k );
+   if ( itr == _map.end() )
+      return {};
+
+   size_type previous = itr->second.size();
+   _map.erase( itr );
+   return previous;
 }
 
 void map_backend::clear() noexcept
@@ -57,4 +70,12 @@ iterator map_backend::lower_bound( const key_type& k )
    return iterator( std::make_unique< map_iterator >( std::make_unique< map_iterator::iterator_impl >( _map.lower_bound( k ) ), _map ) );
 }
 
+void map_backend::drain( const std::function< void( const key_type&, value_type&& ) >& f )
+{
+   for ( auto& [ key, value ] : _map )
+      f( key, std::move( value ) );
+
+   _map.clear();
+}
+
 } // koinos::state_db::backends::map
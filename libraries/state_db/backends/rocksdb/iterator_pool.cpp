@@ -0,0 +1,41 @@
+#include <koinos/state_db/backends/rocksdb/iterator_pool.hpp>
+
+namespace koinos::state_db::backends::rocksdb {
+
+iterator_pool::iterator_pool( std::size_t max_size ) : _max_size( max_size ) {}
+
+iterator_pool::~iterator_pool() {}
+
+std::unique_ptr< ::rocksdb::Iterator > iterator_pool::acquire( generation_type& generation )
+{
+   std::lock_guard lock( _mutex );
+   generation = _generation;
+
+   if ( _iterators.empty() )
+      return std::unique_ptr< ::rocksdb::Iterator >();
+
+   auto itr = std::move( _iterators.back() );
+   _iterators.pop_back();
+   return itr;
+}
+
+void iterator_pool::release( std::unique_ptr< ::rocksdb::Iterator > itr, generation_type generation )
+{
+   std::lock_guard lock( _mutex );
+
+   // An iterator from an earlier generation has a stale view and is destroyed
+   if ( generation == _generation && _iterators.size() < _max_size )
+      _iterators.emplace_back( std::move( itr ) );
+}
+
+void iterator_pool::invalidate()
+{
+   // The stale iterators are destroyed outside of the lock
+   std::vector< std::unique_ptr< ::rocksdb::Iterator > > iterators;
+
+   std::lock_guard lock( _mutex );
+   _generation++;
+   iterators.swap( _iterators );
+}
+
+} // koinos::state_db::backends::rocksdb
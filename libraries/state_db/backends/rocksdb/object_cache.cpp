@@ -10,7 +10,12 @@ std::shared_ptr< const object_cache::value_type > object_cache::get( const key_t
 {
    auto itr = _object_map.find( k );
    if ( itr == _object_map.end() )
+   {
+      _stats.misses++;
       return std::shared_ptr< value_type >();
+   }
+
+   _stats.hits++;
 
    // Erase the entry from the list and push front
    _lru_list.erase( itr->second.second );
@@ -22,15 +27,17 @@ std::shared_ptr< const object_cache::value_type > object_cache::get( const key_t
    return val;
 }
 
-std::shared_ptr< const object_cache::value_type > object_cache::put( const key_type& k, const value_type& v )
+std::shared_ptr< const object_cache::value_type > object_cache::put( const key_type& k, value_type v )
 {
    if ( auto itr = _object_map.find( k ); itr != _object_map.end() )
    {
       _cache_size -= itr->second.first->size();
+      _lru_list.erase( itr->second.second );
+      _object_map.erase( itr );
    }
 
    // If the cache is full, remove the last entry from the map and pop back
-   while ( _cache_size + v.size() > _cache_max_size )
+   while ( _cache_size + v.size() > _cache_max_size && !_lru_list.empty() )
    {
       auto back = _lru_list.back();
       auto mapping = _object_map[ back ];
@@ -39,22 +46,35 @@ std::shared_ptr< const object_cache::value_type > object_cache::put( const key_t
       _lru_list.pop_back();
    }
 
-   auto val_ptr = std::make_shared< const value_type >( v );
+   _cache_size += v.size();
+   auto val_ptr = std::make_shared< const value_type >( std::move( v ) );
    _lru_list.push_front( k );
    _object_map[ k ] = std::make_pair( val_ptr, _lru_list.begin() );
-   _cache_size += v.size();
 
    return val_ptr;
 }
 
+bool object_cache::try_put( const key_type& k, value_type v, std::size_t max_size )
+{
+   if ( _object_map.find( k ) != _object_map.end() || _cache_size + v.size() > max_size )
+      return false;
+
+   _cache_size += v.size();
+   auto val_ptr = std::make_shared< const value_type >( std::move( v ) );
+   _lru_list.push_front( k );
+   _object_map[ k ] = std::make_pair( val_ptr, _lru_list.begin() );
+
+   return true;
+}
+
 void object_cache::remove( const key_type& k )
 {
    auto itr = _object_map.find( k );
    if ( itr != _object_map.end() )
    {
       _cache_size -= itr->second.first->size();
-      _object_map.erase( itr );
       _lru_list.erase( itr->second.second );
+      _object_map.erase( itr );
    }
 }
 
@@ -63,10 +83,21 @@ void object_cache::remove( const ::rocksdb::Slice& k )
    remove( std::string( k.data(), k.size() ) );
 }
 
+bool object_cache::contains( const key_type& k ) const
+{
+   return _object_map.find( k ) != _object_map.end();
+}
+
 void object_cache::clear()
 {
    _object_map.clear();
    _lru_list.clear();
+   _cache_size = 0;
+}
+
+const cache_stats& object_cache::stats() const
+{
+   return _stats;
 }
 
 std::mutex& object_cache::get_mutex()
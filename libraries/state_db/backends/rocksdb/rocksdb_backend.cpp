@@ -7,12 +7,15 @@
 
 #include <rocksdb/convenience.h>
 #include <rocksdb/filter_policy.h>
+#include <rocksdb/version.h>
 
 namespace koinos::state_db::backends::rocksdb {
 
 namespace constants {
    constexpr std::size_t cache_size = 64 << 20; // 64 MB
+   constexpr std::size_t prefetch_cache_size = cache_size + ( 16 << 20 ); // Prefetches never evict, up to 16 MB over
    constexpr std::size_t max_open_files = 64;
+   constexpr std::size_t iterator_pool_size = 64;
 
    constexpr std::size_t default_column_index  = 0;
    const std::string objects_column_name = "objects";
@@ -31,6 +34,16 @@ namespace constants {
    const crypto::multihash merkle_root_default = crypto::multihash::zero( crypto::multicodec::sha2_256 );
 } // constants
 
+// MultiGet reads its batch with asynchronous I/O from RocksDB 7.6, older releases read it synchronously
+::rocksdb::ReadOptions multi_get_options( const ::rocksdb::ReadOptions& ropts )
+{
+   auto opts = ropts;
+#if ROCKSDB_MAJOR > 7 || ( ROCKSDB_MAJOR == 7 && ROCKSDB_MINOR >= 6 )
+   opts.async_io = true;
+#endif
+   return opts;
+}
+
 bool setup_database( const std::filesystem::path& p )
 {
    std::vector< ::rocksdb::ColumnFamilyDescriptor > defs;
@@ -123,7 +136,8 @@ bool setup_database( const std::filesystem::path& p )
 
 rocksdb_backend::rocksdb_backend() :
    _cache( std::make_shared< object_cache >( constants::cache_size ) ),
-   _ropts( std::make_shared< ::rocksdb::ReadOptions >() )
+   _ropts( std::make_shared< ::rocksdb::ReadOptions >() ),
+   _iterators( std::make_shared< iterator_pool >( constants::iterator_pool_size ) )
 {}
 
 rocksdb_backend::~rocksdb_backend()
@@ -188,10 +202,12 @@ void rocksdb_backend::close()
       flush();
 
       ::rocksdb::CancelAllBackgroundWork( &*_db, true );
+      _iterators->invalidate();
+      std::lock_guard lock( _cache->get_mutex() );
       _handles.clear();
       _db.reset();
-      std::lock_guard lock( _cache->get_mutex() );
       _cache->clear();
+      _write_generation++;
    }
 }
 
@@ -208,7 +224,9 @@ void rocksdb_backend::flush()
 void rocksdb_backend::start_write_batch()
 {
    KOINOS_ASSERT( !_write_batch, rocksdb_session_in_progress, "session already in progress" );
+   std::lock_guard lock( _cache->get_mutex() );
    _write_batch.emplace();
+   _write_generation++;
 }
 
 void rocksdb_backend::end_write_batch()
@@ -217,7 +235,10 @@ void rocksdb_backend::end_write_batch()
    {
       auto status = _db->Write( _wopts, &*_write_batch );
       KOINOS_ASSERT( status.ok(), rocksdb_write_exception, "unable to write session to rocksdb database" + ( status.getState() ? ", " + std::string( status.getState() ) : "" ) );
+      _iterators->invalidate();
+      std::lock_guard lock( _cache->get_mutex() );
       _write_batch.reset();
+      _write_generation++;
    }
 }
 
@@ -263,8 +284,8 @@ iterator rocksdb_backend::begin()
 {
    KOINOS_ASSERT( _db, rocksdb_database_not_open_exception, "database not open" );
 
-   auto itr = std::make_unique< rocksdb_iterator >( _db, _handles[ constants::objects_column_index ], _ropts, _cache );
-   itr->_iter = std::unique_ptr< ::rocksdb::Iterator >( _db->NewIterator( *_ropts, &*_handles[ constants::objects_column_index ] ) );
+   auto itr = make_iterator();
+   itr->acquire();
    itr->_iter->SeekToFirst();
 
    return iterator( std::unique_ptr< abstract_iterator >( std::move( itr ) ) );
@@ -274,16 +295,17 @@ iterator rocksdb_backend::end()
 {
    KOINOS_ASSERT( _db, rocksdb_database_not_open_exception, "database not open" );
 
-   auto itr = std::make_unique< rocksdb_iterator >( _db, _handles[ constants::objects_column_index ], _ropts, _cache );
-   itr->_iter = std::unique_ptr< ::rocksdb::Iterator >( _db->NewIterator( *_ropts, &*_handles[ constants::objects_column_index ] ) );
-
-   return iterator( std::unique_ptr< abstract_iterator >( std::move( itr ) ) );
+   // The end sentinel holds no RocksDB iterator until it is decremented
+   return iterator( std::unique_ptr< abstract_iterator >( make_iterator() ) );
 }
 
-void rocksdb_backend::put( const key_type& k, const value_type& v )
+std::optional< rocksdb_backend::size_type > rocksdb_backend::put( const key_type& k, value_type&& v )
 {
    KOINOS_ASSERT( _db, rocksdb_database_not_open_exception, "database not open" );
-   bool exists = get( k );
+
+   std::optional< size_type > previous;
+   if ( auto ptr = get( k ); ptr )
+      previous = ptr->size();
 
    ::rocksdb::Status status;
 
@@ -305,13 +327,19 @@ void rocksdb_backend::put( const key_type& k, const value_type& v )
 
    KOINOS_ASSERT( status.ok(), rocksdb_write_exception, "unable to write to rocksdb database" + ( status.getState() ? ", " + std::string( status.getState() ) : "" ) );
 
-   if ( !exists )
+   if ( !_write_batch )
+      _iterators->invalidate();
+
+   if ( !previous )
    {
       _size++;
    }
 
    std::lock_guard lock( _cache->get_mutex() );
-   _cache->put( k, v );
+   _cache->put( k, std::move( v ) );
+   _write_generation++;
+
+   return previous;
 }
 
 const rocksdb_backend::value_type* rocksdb_backend::get( const key_type& k ) const
@@ -335,17 +363,78 @@ const rocksdb_backend::value_type* rocksdb_backend::get( const key_type& k ) con
 
    if ( status.ok() )
    {
-      return &*_cache->put( k, value );
+      return &*_cache->put( k, std::move( value ) );
    }
 
    return nullptr;
 }
 
-void rocksdb_backend::erase( const key_type& k )
+std::vector< std::optional< rocksdb_backend::value_type > > rocksdb_backend::multi_get( const std::vector< key_type >& keys ) const
 {
    KOINOS_ASSERT( _db, rocksdb_database_not_open_exception, "database not open" );
 
-   bool exists = get( k );
+   std::vector< std::optional< value_type > > values( keys.size() );
+   std::vector< ::rocksdb::Slice > misses;
+   std::vector< std::size_t > miss_indices;
+
+   {
+      std::lock_guard lock( _cache->get_mutex() );
+
+      for ( std::size_t i = 0; i < keys.size(); i++ )
+      {
+         if ( auto ptr = _cache->get( keys[ i ] ); ptr )
+         {
+            values[ i ] = *ptr;
+         }
+         else
+         {
+            misses.emplace_back( keys[ i ] );
+            miss_indices.push_back( i );
+         }
+      }
+   }
+
+   if ( misses.empty() )
+      return values;
+
+   // Every cache miss is read in a single batched lookup, without holding the cache lock so the
+   // prefetch thread is not blocked behind the disk reads
+   std::vector< ::rocksdb::PinnableSlice > results( misses.size() );
+   std::vector< ::rocksdb::Status > statuses( misses.size() );
+
+   _db->MultiGet(
+      multi_get_options( *_ropts ),
+      &*_handles[ constants::objects_column_index ],
+      misses.size(),
+      misses.data(),
+      results.data(),
+      statuses.data()
+   );
+
+   // Only the block thread writes, so the values read are still current. A prefetch may have
+   // cached some of them in the meantime, putting them again leaves the same value.
+   std::lock_guard lock( _cache->get_mutex() );
+
+   for ( std::size_t i = 0; i < misses.size(); i++ )
+   {
+      if ( statuses[ i ].ok() )
+      {
+         auto& value = values[ miss_indices[ i ] ].emplace( results[ i ].data(), results[ i ].size() );
+         _cache->put( keys[ miss_indices[ i ] ], value );
+      }
+   }
+
+   return values;
+}
+
+std::optional< rocksdb_backend::size_type > rocksdb_backend::erase( const key_type& k )
+{
+   KOINOS_ASSERT( _db, rocksdb_database_not_open_exception, "database not open" );
+
+   std::optional< size_type > previous;
+   if ( auto ptr = get( k ); ptr )
+      previous = ptr->size();
+
    auto status = _db->Delete(
       _wopts,
       &*_handles[ constants::objects_column_index ],
@@ -353,28 +442,36 @@ void rocksdb_backend::erase( const key_type& k )
 
    KOINOS_ASSERT( status.ok(), rocksdb_write_exception, "unable to write to rocksdb database" + ( status.getState() ? ", " + std::string( status.getState() ) : "" ) );
 
-   if ( exists )
+   _iterators->invalidate();
+
+   if ( previous )
    {
       _size--;
    }
 
    std::lock_guard lock( _cache->get_mutex() );
    _cache->remove( ::rocksdb::Slice( k ) );
+   _write_generation++;
+
+   return previous;
 }
 
 void rocksdb_backend::clear()
 {
    KOINOS_ASSERT( _db, rocksdb_database_not_open_exception, "database not open" );
 
+   _iterators->invalidate();
+
    for ( auto h : _handles )
    {
       _db->DropColumnFamily( &*h );
    }
 
+   std::lock_guard lock( _cache->get_mutex() );
    _handles.clear();
    _db.reset();
-   std::lock_guard lock( _cache->get_mutex() );
    _cache->clear();
+   _write_generation++;
 }
 
 rocksdb_backend::size_type rocksdb_backend::size() const
@@ -388,22 +485,24 @@ iterator rocksdb_backend::find( const key_type& k )
 {
    KOINOS_ASSERT( _db, rocksdb_database_not_open_exception, "database not open" );
 
-   auto itr = std::make_unique< rocksdb_iterator >( _db, _handles[ constants::objects_column_index ], _ropts, _cache );
-   auto itr_ptr = std::unique_ptr< ::rocksdb::Iterator >( _db->NewIterator( *_ropts, &*_handles[ constants::objects_column_index ] ) );
+   auto itr = make_iterator();
+   itr->acquire();
+   itr->_iter->Seek( ::rocksdb::Slice( k ) );
 
-   itr_ptr->Seek( ::rocksdb::Slice( k ) );
+   bool found = false;
 
-   if ( itr_ptr->Valid() )
+   if ( itr->_iter->Valid() )
    {
-      auto key_slice = itr_ptr->key();
+      auto key_slice = itr->_iter->key();
 
-      if ( k.size() == key_slice.size()
-         && memcmp( k.data(), key_slice.data(), k.size() ) == 0 )
-      {
-         itr->_iter = std::move( itr_ptr );
-      }
+      found = k.size() == key_slice.size()
+         && memcmp( k.data(), key_slice.data(), k.size() ) == 0;
    }
 
+   // A miss is returned as the end sentinel, handing the iterator back to the pool
+   if ( !found )
+      itr->release();
+
    return iterator( std::unique_ptr< abstract_iterator >( std::move( itr ) ) );
 }
 
@@ -411,14 +510,18 @@ iterator rocksdb_backend::lower_bound( const key_type& k )
 {
    KOINOS_ASSERT( _db, rocksdb_database_not_open_exception, "database not open" );
 
-   auto itr = std::make_unique< rocksdb_iterator >( _db, _handles[ constants::objects_column_index ], _ropts, _cache );
-   itr->_iter = std::unique_ptr< ::rocksdb::Iterator >( _db->NewIterator( *_ropts, &*_handles[ constants::objects_column_index ] ) );
-
+   auto itr = make_iterator();
+   itr->acquire();
    itr->_iter->Seek( ::rocksdb::Slice( k ) );
 
    return iterator( std::unique_ptr< abstract_iterator >( std::move( itr ) ) );
 }
 
+std::unique_ptr< rocksdb_iterator > rocksdb_backend::make_iterator() const
+{
+   return std::make_unique< rocksdb_iterator >( _db, _handles[ constants::objects_column_index ], _ropts, _cache, _iterators );
+}
+
 void rocksdb_backend::load_metadata()
 {
    KOINOS_ASSERT( _db, rocksdb_database_not_open_exception, "database not open" );
@@ -506,4 +609,67 @@ void rocksdb_backend::store_metadata()
    KOINOS_ASSERT( status.ok(), rocksdb_write_exception, "unable to write to rocksdb database" + ( status.getState() ? ", " + std::string( status.getState() ) : "" ) );
 }
 
+std::size_t rocksdb_backend::prefetch( const std::vector< key_type >& keys )
+{
+   std::shared_ptr< ::rocksdb::DB > db;
+   std::shared_ptr< ::rocksdb::ColumnFamilyHandle > handle;
+   std::vector< ::rocksdb::Slice > misses;
+   uint64_t generation;
+
+   {
+      std::lock_guard lock( _cache->get_mutex() );
+
+      // While a write batch is open the cache is ahead of the database
+      if ( !_db || _write_batch )
+         return 0;
+
+      db = _db;
+      handle = _handles[ constants::objects_column_index ];
+      generation = _write_generation;
+
+      for ( const auto& k : keys )
+      {
+         if ( !_cache->contains( k ) )
+            misses.emplace_back( k );
+      }
+   }
+
+   if ( misses.empty() )
+      return 0;
+
+   std::vector< ::rocksdb::PinnableSlice > results( misses.size() );
+   std::vector< ::rocksdb::Status > statuses( misses.size() );
+
+   db->MultiGet(
+      multi_get_options( *_ropts ),
+      &*handle,
+      misses.size(),
+      misses.data(),
+      results.data(),
+      statuses.data()
+   );
+
+   std::size_t cached = 0;
+   std::lock_guard lock( _cache->get_mutex() );
+
+   if ( generation != _write_generation )
+      return 0;
+
+   // The block thread holds plain pointers in to cached values, so prefetched values are only added
+   // when nothing has to be evicted for them. Its own next insertion trims the cache back down.
+   for ( std::size_t i = 0; i < misses.size(); i++ )
+   {
+      if ( statuses[ i ].ok() && _cache->try_put( misses[ i ].ToString(), results[ i ].ToString(), constants::prefetch_cache_size ) )
+         cached++;
+   }
+
+   return cached;
+}
+
+cache_stats rocksdb_backend::get_cache_stats() const
+{
+   std::lock_guard lock( _cache->get_mutex() );
+   return _cache->stats();
+}
+
 } // koinos::state_db::backends::rocksdb
@@ -8,12 +8,14 @@ rocksdb_iterator::rocksdb_iterator(
    std::shared_ptr< ::rocksdb::DB > db,
    std::shared_ptr< ::rocksdb::ColumnFamilyHandle > handle,
    std::shared_ptr< const ::rocksdb::ReadOptions > opts,
-   std::shared_ptr< object_cache > cache
+   std::shared_ptr< object_cache > cache,
+   std::shared_ptr< iterator_pool > pool
 ) :
    _db( db ),
    _handle( handle ),
    _opts( opts ),
-   _cache( cache )
+   _cache( cache ),
+   _pool( pool )
 {}
 
 rocksdb_iterator::rocksdb_iterator( const rocksdb_iterator& other ) :
@@ -21,20 +23,22 @@ rocksdb_iterator::rocksdb_iterator( const rocksdb_iterator& other ) :
    _handle( other._handle ),
    _opts( other._opts ),
    _cache( other._cache ),
-   _cache_value( other._cache_value )
+   _cache_value( other._cache_value ),
+   _key( other._key ),
+   _pool( other._pool )
 {
-   if ( other._iter )
+   // A copy of an iterator past the end is the end sentinel
+   if ( other.valid() )
    {
-      _iter.reset( _db->NewIterator( *_opts, &*_handle ) );
-
-      if( other._iter->Valid() )
-      {
-         _iter->Seek( other._iter->key() );
-      }
+      acquire();
+      _iter->Seek( other._iter->key() );
    }
 }
 
-rocksdb_iterator::~rocksdb_iterator() {}
+rocksdb_iterator::~rocksdb_iterator()
+{
+   release();
+}
 
 const rocksdb_iterator::value_type& rocksdb_iterator::operator*() const
 {
@@ -76,7 +80,9 @@ abstract_iterator& rocksdb_iterator::operator--()
 {
    if ( !valid() )
    {
-      _iter.reset( _db->NewIterator( *_opts, &*_handle ) );
+      if ( !_iter )
+         acquire();
+
       _iter->SeekToLast();
    }
    else
@@ -100,6 +106,20 @@ std::unique_ptr< abstract_iterator > rocksdb_iterator::copy() const
    return std::make_unique< rocksdb_iterator >( *this );
 }
 
+void rocksdb_iterator::acquire()
+{
+   _iter = _pool->acquire( _generation );
+
+   if ( !_iter )
+      _iter.reset( _db->NewIterator( *_opts, &*_handle ) );
+}
+
+void rocksdb_iterator::release()
+{
+   if ( _iter )
+      _pool->release( std::move( _iter ), _generation );
+}
+
 void rocksdb_iterator::update_cache_value() const
 {
    if ( valid() )
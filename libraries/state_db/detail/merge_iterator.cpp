@@ -27,7 +27,7 @@ const iterator_wrapper& iterator_wrapper::self() const
 
 bool iterator_wrapper::valid() const
 {
-   return itr != backend->end();
+   return itr.valid();
 }
 
 bool iterator_compare_less::operator()( const iterator_wrapper& lhs, const iterator_wrapper& rhs ) const
@@ -251,6 +251,11 @@ const merge_state::value_type* merge_state::find( const key_type& key ) const
    return _head->find( key );
 }
 
+std::vector< std::optional< merge_state::value_type > > merge_state::find( const std::vector< key_type >& keys ) const
+{
+   return _head->find( keys );
+}
+
 merge_iterator merge_state::lower_bound( const key_type& key ) const
 {
    return merge_iterator( _head, [&]( std::shared_ptr< backends::abstract_backend > backend )
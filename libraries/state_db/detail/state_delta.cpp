@@ -2,6 +2,8 @@
 
 #include <koinos/crypto/merkle_tree.hpp>
 
+#include <numeric>
+
 namespace koinos::state_db::detail {
 
 using backend_type = state_delta::backend_type;
@@ -28,18 +30,34 @@ state_delta::state_delta( const std::filesystem::path& p )
    _backend = backend;
 }
 
-void state_delta::put( const key_type& k, const value_type& v )
+std::optional< state_delta::size_type > state_delta::put( const key_type& k, value_type&& v )
 {
-   _backend->put( k, v );
+   auto previous = _backend->put( k, std::move( v ) );
+
+   // A key new to this delta may still shadow a value in a parent
+   if ( !previous && !is_root() && !is_removed( k ) )
+   {
+      if ( auto val_ptr = _parent->find( k ); val_ptr )
+         previous = val_ptr->size();
+   }
+
+   return previous;
 }
 
-void state_delta::erase( const key_type& k )
+std::optional< state_delta::size_type > state_delta::erase( const key_type& k )
 {
-   if ( find( k ) )
+   auto previous = _backend->erase( k );
+
+   if ( !previous && !is_root() && !is_removed( k ) )
    {
-      _backend->erase( k );
-      _removed_objects.insert( k );
+      if ( auto val_ptr = _parent->find( k ); val_ptr )
+         previous = val_ptr->size();
    }
+
+   if ( previous )
+      _removed_objects.insert( k );
+
+   return previous;
 }
 
 const value_type* state_delta::find( const key_type& key ) const
@@ -53,6 +71,49 @@ const value_type* state_delta::find( const key_type& key ) const
    return is_root() ? nullptr : _parent->find( key );
 }
 
+std::vector< std::optional< value_type > > state_delta::find( const std::vector< key_type >& keys ) const
+{
+   std::vector< std::optional< value_type > > values( keys.size() );
+
+   std::vector< std::size_t > pending( keys.size() );
+   std::iota( pending.begin(), pending.end(), 0 );
+
+   const state_delta* delta = this;
+
+   for ( ; !delta->is_root() && !pending.empty(); delta = delta->_parent.get() )
+   {
+      std::size_t unresolved = 0;
+
+      for ( std::size_t i = 0; i < pending.size(); i++ )
+      {
+         const auto& key = keys[ pending[ i ] ];
+
+         if ( auto val_ptr = delta->_backend->get( key ); val_ptr )
+            values[ pending[ i ] ] = *val_ptr;
+         else if ( !delta->is_removed( key ) )
+            pending[ unresolved++ ] = pending[ i ];
+      }
+
+      pending.resize( unresolved );
+   }
+
+   if ( pending.empty() )
+      return values;
+
+   std::vector< key_type > root_keys;
+   root_keys.reserve( pending.size() );
+
+   for ( auto i : pending )
+      root_keys.push_back( keys[ i ] );
+
+   auto root_values = delta->_backend->multi_get( root_keys );
+
+   for ( std::size_t i = 0; i < pending.size(); i++ )
+      values[ pending[ i ] ] = std::move( root_values[ i ] );
+
+   return values;
+}
+
 void state_delta::squash()
 {
    if ( is_root() )
@@ -72,15 +133,21 @@ void state_delta::squash()
       }
    }
 
-   for ( auto itr = _backend->begin(); itr != _backend->end(); ++itr )
+   // The values move into the parent, leaving this delta empty so reads through it see the parent
+   std::static_pointer_cast< backends::map::map_backend >( _backend )->drain( [&]( const key_type& key, value_type&& value )
    {
-      _parent->_backend->put( itr.key(), *itr );
+      _parent->_backend->put( key, std::move( value ) );
 
       if ( !_parent->is_root() )
       {
-         _parent->_removed_objects.erase( itr.key() );
+         _parent->_removed_objects.erase( key );
       }
-   }
+   } );
+
+   _removed_objects.clear();
+
+   std::lock_guard< std::mutex > lock( _merkle_mutex );
+   _merkle_root.reset();
 }
 
 void state_delta::commit_helper()
@@ -97,10 +164,11 @@ void state_delta::commit_helper()
       _parent->_backend->erase( r_key );
    }
 
-   for ( auto itr = _backend->begin(); itr != _backend->end(); ++itr )
+   // This delta's map is replaced by the root backend below, so its values can be moved
+   std::static_pointer_cast< backends::map::map_backend >( _backend )->drain( [&]( const key_type& key, value_type&& value )
    {
-      _parent->_backend->put( itr.key(), *itr );
-   }
+      _parent->_backend->put( key, std::move( value ) );
+   } );
 
    std::static_pointer_cast< backends::rocksdb::rocksdb_backend >( _parent->_backend )->end_write_batch();
 
@@ -163,6 +231,9 @@ void state_delta::set_revision( uint64_t revision )
 
 crypto::multihash state_delta::get_merkle_root() const
 {
+   // The root of a finalized delta may be computed in the background while it is read elsewhere
+   std::lock_guard< std::mutex > lock( _merkle_mutex );
+
    if ( !_merkle_root )
    {
       std::vector< std::string > object_keys;
@@ -2,6 +2,9 @@
 
 #include <koinos/state_db/backends/iterator.hpp>
 
+#include <optional>
+#include <vector>
+
 namespace koinos::state_db::backends {
 
 class abstract_backend
@@ -16,9 +19,19 @@ class abstract_backend
       virtual iterator begin() = 0;
       virtual iterator end() = 0;
 
-      virtual void put( const key_type& k, const value_type& v ) = 0;
+      /**
+       * Writes take the value and return the size of the value they replaced or erased,
+       * if there was one, so callers need not look the key up first.
+       */
+      virtual std::optional< size_type > put( const key_type& k, value_type&& v ) = 0;
       virtual const value_type* get( const key_type& ) const = 0;
-      virtual void erase( const key_type& k ) = 0;
+
+      /**
+       * Reads several keys at once, copying each value found. Backends that can batch
+       * their lookups override this; by default each key is read in turn.
+       */
+      virtual std::vector< std::optional< value_type > > multi_get( const std::vector< key_type >& keys ) const;
+      virtual std::optional< size_type > erase( const key_type& k ) = 0;
       virtual void clear() = 0;
 
       virtual size_type size() const = 0;
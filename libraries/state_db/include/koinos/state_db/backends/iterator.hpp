@@ -50,12 +50,12 @@ class iterator final
 
       iterator& operator=( iterator&& other );
 
+      bool valid() const;
+
       friend bool operator==( const iterator& x, const iterator& y );
       friend bool operator!=( const iterator& x, const iterator& y );
 
    private:
-      bool valid() const;
-
       std::unique_ptr< abstract_iterator > _itr;
 };
 
@@ -3,6 +3,8 @@
 #include <koinos/state_db/backends/backend.hpp>
 #include <koinos/state_db/backends/map/map_iterator.hpp>
 
+#include <functional>
+
 namespace koinos::state_db::backends::map {
 
 class map_backend final : public abstract_backend {
@@ -19,9 +21,9 @@ class map_backend final : public abstract_backend {
       virtual iterator end() noexcept override;
 
       // Modifiers
-      virtual void put( const key_type& k, const value_type& v ) override;
+      virtual std::optional< size_type > put( const key_type& k, value_type&& v ) override;
       virtual const value_type* get( const key_type& ) const override;
-      virtual void erase( const key_type& k ) override;
+      virtual std::optional< size_type > erase( const key_type& k ) override;
       virtual void clear() noexcept override;
 
       virtual size_type size() const noexcept override;
@@ -30,6 +32,11 @@ class map_backend final : public abstract_backend {
       virtual iterator find( const key_type& k ) override;
       virtual iterator lower_bound( const key_type& k ) override;
 
+      /**
+       * Moves every entry out to f and leaves the backend empty.
+       */
+      void drain( const std::function< void( const key_type&, value_type&& ) >& f );
+
    private:
       std::map< key_type, value_type > _map;
 };
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <rocksdb/db.h>
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace koinos::state_db::backends::rocksdb {
+
+/**
+ * Holds released RocksDB iterators for reuse.
+ *
+ * An iterator sees the database as it was when the iterator was created, so every write to the
+ * database invalidates the pool. Iterators are tagged with the generation of the pool when they
+ * are acquired and are only taken back if no write has happened since, which keeps every pooled
+ * iterator on the same view of the database.
+ */
+class iterator_pool
+{
+   public:
+      using generation_type = uint64_t;
+
+      iterator_pool( std::size_t max_size );
+      ~iterator_pool();
+
+      // Returns a pooled iterator, or nullptr if there is none, and the generation to release it with
+      std::unique_ptr< ::rocksdb::Iterator > acquire( generation_type& generation );
+      void release( std::unique_ptr< ::rocksdb::Iterator > itr, generation_type generation );
+
+      void invalidate();
+
+   private:
+      std::vector< std::unique_ptr< ::rocksdb::Iterator > > _iterators;
+      generation_type                                       _generation = 0;
+      const std::size_t                                     _max_size;
+      std::mutex                                            _mutex;
+};
+
+} // koinos::state_db::backends::rocksdb
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <koinos/state_db/backends/types.hpp>
+#include <koinos/state_db/state_db_types.hpp>
 
 #include <rocksdb/slice.h>
 
@@ -34,19 +35,30 @@ class object_cache
       std::size_t       _cache_size = 0;
       const std::size_t _cache_max_size;
       std::mutex        _mutex;
+      cache_stats       _stats;
 
    public:
       object_cache( std::size_t size );
       ~object_cache();
 
       std::shared_ptr< const value_type > get( const key_type& k );
-      std::shared_ptr< const value_type > put( const key_type& k, const value_type& v );
+      std::shared_ptr< const value_type > put( const key_type& k, value_type v );
+
+      // Adds an object that is not cached without evicting any other, as long as the cache stays
+      // within max_size. Objects handed out by get remain owned by the cache, so this is the only
+      // insertion that is safe while another thread is reading them.
+      bool try_put( const key_type& k, value_type v, std::size_t max_size );
 
       void remove( const key_type& k );
       void remove( const ::rocksdb::Slice& k );
 
+      // Checks for an object without counting a lookup or refreshing its place in the cache
+      bool contains( const key_type& k ) const;
+
       void clear();
 
+      const cache_stats& stats() const;
+
       std::mutex& get_mutex();
 };
 
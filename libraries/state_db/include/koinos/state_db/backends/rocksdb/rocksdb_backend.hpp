@@ -2,6 +2,7 @@
 
 #include <koinos/crypto/multihash.hpp>
 #include <koinos/state_db/backends/backend.hpp>
+#include <koinos/state_db/backends/rocksdb/iterator_pool.hpp>
 #include <koinos/state_db/backends/rocksdb/object_cache.hpp>
 #include <koinos/state_db/backends/rocksdb/rocksdb_iterator.hpp>
 
@@ -10,6 +11,7 @@
 #include <filesystem>
 #include <string>
 #include <utility>
+#include <vector>
 
 namespace koinos::state_db::backends::rocksdb {
 
@@ -43,9 +45,10 @@ class rocksdb_backend final : public abstract_backend {
       virtual iterator end() override;
 
       // Modifiers
-      virtual void put( const key_type& k, const value_type& v ) override;
+      virtual std::optional< size_type > put( const key_type& k, value_type&& v ) override;
       virtual const value_type* get( const key_type& ) const override;
-      virtual void erase( const key_type& k ) override;
+      virtual std::vector< std::optional< value_type > > multi_get( const std::vector< key_type >& keys ) const override;
+      virtual std::optional< size_type > erase( const key_type& k ) override;
       virtual void clear() override;
 
       virtual size_type size() const override;
@@ -54,10 +57,23 @@ class rocksdb_backend final : public abstract_backend {
       virtual iterator find( const key_type& k ) override;
       virtual iterator lower_bound( const key_type& k ) override;
 
+      /**
+       * Reads objects that are not cached into the object cache in a single batch.
+       *
+       * The cache lock is not held during the read, so this may run on another thread while
+       * the backend is in use. If a write reaches the backend before the read completes, the
+       * objects read may be stale and are not cached. Returns the number of objects cached.
+       */
+      std::size_t prefetch( const std::vector< key_type >& keys );
+
+      cache_stats get_cache_stats() const;
+
    private:
       void load_metadata();
       void store_metadata();
 
+      std::unique_ptr< rocksdb_iterator > make_iterator() const;
+
       using column_handles = std::vector< std::shared_ptr< ::rocksdb::ColumnFamilyHandle > >;
 
       std::shared_ptr< ::rocksdb::DB >          _db;
@@ -66,6 +82,8 @@ class rocksdb_backend final : public abstract_backend {
       ::rocksdb::WriteOptions                   _wopts;
       std::shared_ptr< ::rocksdb::ReadOptions > _ropts;
       mutable std::shared_ptr< object_cache >   _cache;
+      uint64_t                                  _write_generation = 0; // Guarded by the cache mutex
+      std::shared_ptr< iterator_pool >          _iterators;
       size_type                                 _size = 0;
       size_type                                 _revision = 0;
       crypto::multihash                         _id;
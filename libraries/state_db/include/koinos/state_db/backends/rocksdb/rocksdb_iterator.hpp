@@ -1,6 +1,7 @@
 #pragma once
 
 #include <koinos/state_db/backends/iterator.hpp>
+#include <koinos/state_db/backends/rocksdb/iterator_pool.hpp>
 #include <koinos/state_db/backends/rocksdb/object_cache.hpp>
 
 #include <rocksdb/db.h>
@@ -20,7 +21,8 @@ class rocksdb_iterator final : public abstract_iterator
          std::shared_ptr< ::rocksdb::DB > db,
          std::shared_ptr< ::rocksdb::ColumnFamilyHandle > handle,
          std::shared_ptr< const ::rocksdb::ReadOptions > opts,
-         std::shared_ptr< object_cache > cache );
+         std::shared_ptr< object_cache > cache,
+         std::shared_ptr< iterator_pool > pool );
       rocksdb_iterator( const rocksdb_iterator& other );
       virtual ~rocksdb_iterator() override;
 
@@ -39,6 +41,10 @@ class rocksdb_iterator final : public abstract_iterator
 
       void update_cache_value() const;
 
+      // An iterator without a RocksDB iterator is the end sentinel
+      void acquire();
+      void release();
+
       std::shared_ptr< ::rocksdb::DB >                 _db;
       std::shared_ptr< ::rocksdb::ColumnFamilyHandle > _handle;
       std::unique_ptr< ::rocksdb::Iterator >           _iter;
@@ -46,6 +52,8 @@ class rocksdb_iterator final : public abstract_iterator
       mutable std::shared_ptr< object_cache >          _cache;
       mutable std::shared_ptr< const value_type >      _cache_value;
       mutable std::shared_ptr< const key_type >        _key;
+      std::shared_ptr< iterator_pool >                 _pool;
+      iterator_pool::generation_type                   _generation = 0;
 };
 
 } // koinos::state_db::backends::rocksdb
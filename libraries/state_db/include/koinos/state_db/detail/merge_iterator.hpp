@@ -154,6 +154,7 @@ class merge_state
       merge_iterator end() const;
 
       const value_type* find( const key_type& key ) const;
+      std::vector< std::optional< value_type > > find( const std::vector< key_type >& keys ) const;
       merge_iterator lower_bound( const key_type& key ) const;
 
    private:
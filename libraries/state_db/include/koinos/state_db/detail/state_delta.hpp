@@ -9,7 +9,10 @@
 #include <any>
 #include <filesystem>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <unordered_set>
+#include <vector>
 
 namespace koinos::state_db::detail {
 
@@ -29,16 +32,29 @@ namespace koinos::state_db::detail {
          state_node_id                              _id;
          uint64_t                                   _revision = 0;
          mutable std::optional< crypto::multihash > _merkle_root;
+         mutable std::mutex                         _merkle_mutex;
 
       public:
          state_delta( std::shared_ptr< state_delta > parent, const state_node_id& id = state_node_id() );
          state_delta( const std::filesystem::path& p );
          ~state_delta() {};
 
-         void put( const key_type& k, const value_type& v );
-         void erase( const key_type& k );
+         using size_type     = backend_type::size_type;
+
+         /**
+          * Writes return the size of the value they replaced or erased as seen through
+          * this delta and its parents, if there was one.
+          */
+         std::optional< size_type > put( const key_type& k, value_type&& v );
+         std::optional< size_type > erase( const key_type& k );
          const value_type* find( const key_type& key ) const;
 
+         /**
+          * Finds several keys at once. Keys are resolved against the deltas first and
+          * any that reach the root are read from its backend in a single batch.
+          */
+         std::vector< std::optional< value_type > > find( const std::vector< key_type >& keys ) const;
+
          void squash();
          void commit();
 
@@ -8,6 +8,7 @@
 #include <cstddef>
 #include <filesystem>
 #include <memory>
+#include <optional>
 #include <vector>
 
 namespace koinos::state_db {
@@ -45,6 +46,14 @@ class abstract_state_node
        */
       const object_value* get_object( const object_space& space, const object_key& key ) const;
 
+      /**
+       * Get several objects from a space at once.
+       *
+       * - The result holds a copy of each object's value, in the order of keys, or nullopt if it does not exist
+       * - Keys not modified in this node or its parents are read from the database in a single batch
+       */
+      std::vector< std::optional< object_value > > get_objects( const object_space& space, const std::vector< object_key >& keys ) const;
+
       /**
        * Get the next object.
        *
@@ -73,6 +82,13 @@ class abstract_state_node
        */
       int32_t put_object( const object_space& space, const object_key& key, const object_value* val );
 
+      /**
+       * Write an object into the state_node, taking its value.
+       *
+       * The value is moved through the node's deltas down to the database rather than copied.
+       */
+      int32_t put_object( const object_space& space, const object_key& key, object_value&& val );
+
       /**
        * Remove an object from the state_node
        */
@@ -286,6 +302,21 @@ class database final
        */
       state_node_ptr get_root() const;
 
+      /**
+       * Read objects into the object cache ahead of their use.
+       *
+       * Objects are read from the database in a single batch. Unlike other database methods,
+       * this may be called from any thread while the database is in use. Objects read while
+       * a node is being committed are discarded rather than cached. Returns the number of
+       * objects read into the cache.
+       */
+      std::size_t prefetch_objects( const std::vector< std::pair< object_space, object_key > >& objects );
+
+      /**
+       * Get the hits and misses of the object cache since the database was opened.
+       */
+      cache_stats get_cache_stats() const;
+
    private:
       std::unique_ptr< detail::database_impl > impl;
 };
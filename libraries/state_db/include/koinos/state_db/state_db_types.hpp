@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 #include <string>
 
 #include <koinos/exception.hpp>
@@ -14,6 +15,12 @@ using object_space  = chain::object_space;
 using object_key    = std::string;
 using object_value  = std::string;
 
+struct cache_stats
+{
+   uint64_t hits   = 0;
+   uint64_t misses = 0;
+};
+
 KOINOS_DECLARE_EXCEPTION( state_db_exception );
 
 KOINOS_DECLARE_DERIVED_EXCEPTION( database_not_open, state_db_exception );
@@ -8,6 +8,7 @@
 
 #include <cstring>
 #include <deque>
+#include <mutex>
 #include <optional>
 #include <unordered_set>
 #include <utility>
@@ -77,9 +78,10 @@ class state_node_impl final
       ~state_node_impl() {}
 
       const object_value* get_object( const object_space& space, const object_key& key ) const;
+      std::vector< std::optional< object_value > > get_objects( const object_space& space, const std::vector< object_key >& keys ) const;
       std::pair< const object_value*, const object_key > get_next_object( const object_space& space, const object_key& key ) const;
       std::pair< const object_value*, const object_key > get_prev_object( const object_space& space, const object_key& key ) const;
-      int32_t put_object( const object_space& space, const object_key& key, const object_value* val );
+      int32_t put_object( const object_space& space, const object_key& key, object_value&& val );
       void remove_object( const object_space& space, const object_key& key );
       crypto::multihash get_merkle_root() const;
 
@@ -118,6 +120,9 @@ class database_impl final
 
       bool is_open() const;
 
+      std::size_t prefetch_objects( const std::vector< std::pair< object_space, object_key > >& objects );
+      cache_stats get_cache_stats() const;
+
       std::filesystem::path                     _path;
       std::function< void( state_node_ptr ) >   _init_func = nullptr;
 
@@ -125,6 +130,10 @@ class database_impl final
       state_node_ptr                            _head;
       std::map< state_node_id, state_node_ptr > _fork_heads;
       state_node_ptr                            _root;
+
+      // The root backend is shared with threads prefetching objects
+      std::shared_ptr< backends::rocksdb::rocksdb_backend > _backend;
+      mutable std::mutex                        _backend_mutex;
 };
 
 void database_impl::reset()
@@ -159,10 +168,18 @@ void database_impl::open( const std::filesystem::path& p, std::function< void( s
    _fork_heads.insert_or_assign( _head->id(), _head );
 
    _path = p;
+
+   std::lock_guard< std::mutex > lock( _backend_mutex );
+   _backend = std::static_pointer_cast< backends::rocksdb::rocksdb_backend >( root->impl->_state->backend() );
 }
 
 void database_impl::close()
 {
+   {
+      std::lock_guard< std::mutex > lock( _backend_mutex );
+      _backend.reset();
+   }
+
    _fork_heads.clear();
    _root.reset();
    _head.reset();
@@ -344,6 +361,39 @@ bool database_impl::is_open() const
    return (bool)_root && (bool)_head;
 }
 
+std::size_t database_impl::prefetch_objects( const std::vector< std::pair< object_space, object_key > >& objects )
+{
+   std::shared_ptr< backends::rocksdb::rocksdb_backend > backend;
+
+   {
+      std::lock_guard< std::mutex > lock( _backend_mutex );
+      backend = _backend;
+   }
+
+   if ( !backend )
+      return 0;
+
+   std::vector< std::string > keys;
+   keys.reserve( objects.size() );
+
+   for ( const auto& [ space, key ] : objects )
+   {
+      chain::database_key db_key;
+      *db_key.mutable_space() = space;
+      db_key.set_key( key );
+      keys.emplace_back( util::converter::as< std::string >( db_key ) );
+   }
+
+   return backend->prefetch( keys );
+}
+
+cache_stats database_impl::get_cache_stats() const
+{
+   std::lock_guard< std::mutex > lock( _backend_mutex );
+   KOINOS_ASSERT( _backend, database_not_open, "database is not open" );
+   return _backend->get_cache_stats();
+}
+
 const object_value* state_node_impl::get_object( const object_space& space, const object_key& key ) const
 {
    chain::database_key db_key;
@@ -361,6 +411,23 @@ const object_value* state_node_impl::get_object( const object_space& space, cons
    return nullptr;
 }
 
+std::vector< std::optional< object_value > > state_node_impl::get_objects( const object_space& space, const std::vector< object_key >& keys ) const
+{
+   std::vector< std::string > key_strings;
+   key_strings.reserve( keys.size() );
+
+   chain::database_key db_key;
+   *db_key.mutable_space() = space;
+
+   for ( const auto& key : keys )
+   {
+      db_key.set_key( key );
+      key_strings.emplace_back( util::converter::as< std::string >( db_key ) );
+   }
+
+   return merge_state( _state ).find( key_strings );
+}
+
 std::pair< const object_value*, const object_key > state_node_impl::get_next_object( const object_space& space, const object_key& key ) const
 {
    chain::database_key db_key;
@@ -413,27 +480,21 @@ std::pair< const object_value*, const object_key > state_node_impl::get_prev_obj
    return { nullptr, null_key };
 }
 
-int32_t state_node_impl::put_object( const object_space& space, const object_key& key, const object_value* val )
+int32_t state_node_impl::put_object( const object_space& space, const object_key& key, object_value&& val )
 {
    KOINOS_ASSERT( _is_writable, node_finalized, "cannot write to a finalized node" );
 
    chain::database_key db_key;
    *db_key.mutable_space() = space;
    db_key.set_key( key );
-   auto key_string = util::converter::as< std::string >( db_key );
-
-   auto pobj = merge_state( _state ).find( key_string );
-
-   int32_t bytes_used = 0;
+   int32_t bytes_used = val.size();
+   auto previous = _state->put( util::converter::as< std::string >( db_key ), std::move( val ) );
 
-   if ( pobj != nullptr )
+   if ( previous )
    {
-      bytes_used -= pobj->size();
+      bytes_used -= *previous;
    }
 
-   bytes_used += val->size();
-   _state->put( key_string, *val );
-
    return bytes_used;
 }
 
@@ -463,6 +524,11 @@ const object_value* abstract_state_node::get_object( const object_space& space,
    return impl->get_object( space, key );
 }
 
+std::vector< std::optional< object_value > > abstract_state_node::get_objects( const object_space& space, const std::vector< object_key >& keys ) const
+{
+   return impl->get_objects( space, keys );
+}
+
 std::pair< const object_value*, const object_key > abstract_state_node::get_next_object( const object_space& space, const object_key& key ) const
 {
    return impl->get_next_object( space, key );
@@ -475,7 +541,12 @@ std::pair< const object_value*, const object_key > abstract_state_node::get_prev
 
 int32_t abstract_state_node::put_object( const object_space& space, const object_key& key, const object_value* val )
 {
-   return impl->put_object( space, key, val );
+   return impl->put_object( space, key, object_value( *val ) );
+}
+
+int32_t abstract_state_node::put_object( const object_space& space, const object_key& key, object_value&& val )
+{
+   return impl->put_object( space, key, std::move( val ) );
 }
 
 void abstract_state_node::remove_object( const object_space& space, const object_key& key )
@@ -650,4 +721,14 @@ state_node_ptr database::get_root() const
    return impl->get_root();
 }
 
+std::size_t database::prefetch_objects( const std::vector< std::pair< object_space, object_key > >& objects )
+{
+   return impl->prefetch_objects( objects );
+}
+
+cache_stats database::get_cache_stats() const
+{
+   return impl->get_cache_stats();
+}
+
 } // koinos::state_db
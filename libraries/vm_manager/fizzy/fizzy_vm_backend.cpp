@@ -5,17 +5,26 @@
 
 #include <koinos/vm_manager/fizzy/exceptions.hpp>
 #include <koinos/vm_manager/fizzy/fizzy_vm_backend.hpp>
+#include <koinos/vm_manager/fizzy/module_rewrite.hpp>
 
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 #include <exception>
 #include <optional>
 #include <string>
 #include <iostream>
+#include <vector>
 
 namespace koinos::vm_manager::fizzy {
 
 namespace constants {
-   constexpr uint32_t    fizzy_max_call_depth = 251;
-   constexpr std::size_t module_cache_size    = 32;
+   constexpr uint32_t    fizzy_max_call_depth    = 251;
+   constexpr std::size_t module_cache_size       = 64 * 1024 * 1024;
+   constexpr std::size_t max_pooled_memory_size  = 1024 * 1024;
+   constexpr std::size_t max_pooled_instances    = 4;
+   constexpr std::size_t max_pooled_modules      = 32;
+   constexpr std::size_t reset_page_size         = 4096;
 }
 
 /**
@@ -46,10 +55,6 @@ char* resolve_ptr( FizzyInstance* fizzy_instance, uint32_t ptr, uint32_t size )
    return mem_data + ptr;
 }
 
-fizzy_vm_backend::fizzy_vm_backend() :
-   _cache( constants::module_cache_size ) {}
-fizzy_vm_backend::~fizzy_vm_backend() {}
-
 std::string fizzy_vm_backend::backend_name()
 {
    return "fizzy";
@@ -59,6 +64,11 @@ void fizzy_vm_backend::initialize()
 {
 }
 
+void fizzy_vm_backend::set_module_cache_size( std::size_t bytes )
+{
+   _cache.set_max_bytes( bytes );
+}
+
 std::string fizzy_error_code_name(FizzyErrorCode code) noexcept
 {
    switch( code )
@@ -80,14 +90,41 @@ std::string fizzy_error_code_name(FizzyErrorCode code) noexcept
    }
 }
 
+class fizzy_runner;
+
+/**
+ * An instantiated module.
+ *
+ * Host functions are bound to the instance rather than to the runner using it, so
+ * the instance can be reused by later runs. A reusable instance keeps a snapshot of
+ * its memory and mutable globals as they were after instantiation, which reset()
+ * restores before the instance is pooled. Internal globals are reachable because
+ * every mutable global is exported when the module is parsed.
+ */
+struct fizzy_instance
+{
+   ~fizzy_instance();
+
+   void snapshot();
+   bool reset();
+
+   FizzyInstance*                                      instance = nullptr;
+   fizzy_runner*                                       runner = nullptr;
+   bool                                                reusable = false;
+   std::vector< uint8_t >                              memory_snapshot;
+   std::vector< std::pair< FizzyValue*, FizzyValue > > global_snapshot;
+};
+
 class fizzy_runner
 {
    public:
-      fizzy_runner( abstract_host_api& h, const FizzyModule* m ) : _hapi(h), _module(m) {}
+      fizzy_runner( abstract_host_api& h, fizzy_instance& i ) : _hapi(h), _instance(i)
+      {
+         _instance.runner = this;
+      }
+
       ~fizzy_runner();
 
-      const FizzyModule* parse_bytecode( const char* bytecode_data, size_t bytecode_size );
-      void instantiate_module();
       void call_start();
 
       FizzyExecutionResult _invoke_thunk( const FizzyValue* args, FizzyExecutionContext* fizzy_context ) noexcept;
@@ -95,66 +132,135 @@ class fizzy_runner
 
    private:
       abstract_host_api&     _hapi;
-      const FizzyModule*     _module = nullptr;
-      FizzyInstance*         _instance = nullptr;
+      fizzy_instance&        _instance;
       FizzyExecutionContext* _fizzy_context = nullptr;
       int64_t                _previous_ticks;
       std::exception_ptr     _exception;
+      bool                   _exited = false;
 };
 
 fizzy_runner::~fizzy_runner()
 {
-   if( _instance != nullptr )
+   _instance.runner = nullptr;
+
+   if( _fizzy_context != nullptr )
+      fizzy_free_execution_context(_fizzy_context);
+}
+
+fizzy_instance::~fizzy_instance()
+{
+   // As per fizzy docs, the instance owns its module
+   if( instance != nullptr )
+      fizzy_free_instance( instance );
+}
+
+void fizzy_instance::snapshot()
+{
+   const FizzyModule* module = fizzy_get_instance_module( instance );
+
+   // A start function runs during instantiation and may call the host, so its effects
+   // cannot be replayed by restoring a snapshot
+   if ( fizzy_module_has_start_function( module ) )
+      return;
+
+   // Only exported globals are reachable through the C API. Parsing exports every mutable
+   // global, a module that could not be rewritten is not restored.
+   std::vector< bool > exported( fizzy_get_global_count( module ), false );
+   std::vector< std::pair< FizzyValue*, FizzyValue > > globals;
+
+   for ( uint32_t i = 0; i < fizzy_get_export_count( module ); i++ )
    {
-      fizzy_free_instance( _instance );
-      _instance = nullptr;
-      // As per fizzy docs, don't free _module if _instance was created successfully
-      _module = nullptr;
+      auto desc = fizzy_get_export_description( module, i );
+      if ( desc.kind != FizzyExternalKindGlobal )
+         continue;
+
+      FizzyExternalGlobal global;
+      if ( !fizzy_find_exported_global( instance, desc.name, &global ) )
+         return;
+
+      exported[ desc.index ] = true;
+
+      if ( global.type.is_mutable )
+         globals.emplace_back( global.value, *global.value );
    }
-   else
+
+   for ( uint32_t i = 0; i < exported.size(); i++ )
    {
-      if( _module != nullptr )
-      {
-         // While testing the changes for #400, I was getting malloc errors that resolved themselves
-         // by commenting out this line (freeing already freed memory). It would appear that fizzy_initialize
-         // takes ownership even on failure and this line is not needed.
-         // The bug I ran in to could be replicated via an uploaded contract and is therefore and attack vector.
-         // fizzy_free_module( _module );
-      }
+      if ( fizzy_get_global_type( module, i ).is_mutable && !exported[ i ] )
+         return;
    }
-   if( _fizzy_context != nullptr )
-      fizzy_free_execution_context(_fizzy_context);
+
+   auto mem_size = fizzy_get_instance_memory_size( instance );
+   if ( mem_size > constants::max_pooled_memory_size )
+      return;
+
+   auto mem_data = fizzy_get_instance_memory_data( instance );
+   if ( mem_data != nullptr )
+      memory_snapshot.assign( mem_data, mem_data + mem_size );
+
+   global_snapshot = std::move( globals );
+   reusable = true;
+}
+
+bool fizzy_instance::reset()
+{
+   if ( !reusable )
+      return false;
+
+   // Memory can grow but not shrink, an instance that grew is discarded
+   if ( fizzy_get_instance_memory_size( instance ) != memory_snapshot.size() )
+      return false;
+
+   // Fizzy owns the memory allocation, so writes cannot be tracked. Comparing page by page
+   // restores only the pages a run dirtied and leaves the rest untouched.
+   auto mem_data = fizzy_get_instance_memory_data( instance );
+
+   for ( std::size_t offset = 0; offset < memory_snapshot.size(); offset += constants::reset_page_size )
+   {
+      auto length = std::min( constants::reset_page_size, memory_snapshot.size() - offset );
+
+      if ( std::memcmp( mem_data + offset, memory_snapshot.data() + offset, length ) )
+         std::memcpy( mem_data + offset, memory_snapshot.data() + offset, length );
+   }
+
+   for ( auto& [ global, value ] : global_snapshot )
+      *global = value;
+
+   return true;
 }
 
 const FizzyModule* parse_bytecode( const char* bytecode_data, size_t bytecode_size )
 {
    KOINOS_ASSERT( bytecode_data != nullptr, fizzy_returned_null_exception, "fizzy_instance was unexpectedly null pointer" );
-   auto module_ptr = fizzy_parse(reinterpret_cast< const uint8_t* >( bytecode_data ), bytecode_size, nullptr);
+   auto bytecode = export_mutable_globals( bytecode_data, bytecode_size );
+   auto module_ptr = fizzy_parse(reinterpret_cast< const uint8_t* >( bytecode.data() ), bytecode.size(), nullptr);
    KOINOS_ASSERT( module_ptr != nullptr, module_parse_exception, "could not parse fizzy module" );
    return module_ptr;
 }
 
-void fizzy_runner::instantiate_module()
+std::unique_ptr< fizzy_instance > instantiate_module( const FizzyModule* module )
 {
+   auto instance = std::make_unique< fizzy_instance >();
+
    FizzyExternalFn invoke_thunk = [](void* voidptr_context, FizzyInstance* fizzy_instance, const FizzyValue* args, FizzyExecutionContext* fizzy_context) noexcept -> FizzyExecutionResult
    {
-      fizzy_runner* runner = static_cast< fizzy_runner* >( voidptr_context );
-      return runner->_invoke_thunk( args, fizzy_context );
+      auto instance = static_cast< struct fizzy_instance* >( voidptr_context );
+      return instance->runner->_invoke_thunk( args, fizzy_context );
    };
 
    FizzyValueType invoke_thunk_arg_types[] = {FizzyValueTypeI32, FizzyValueTypeI32, FizzyValueTypeI32, FizzyValueTypeI32, FizzyValueTypeI32};
    size_t invoke_thunk_num_args = 5;
-   FizzyExternalFunction invoke_thunk_fn = {{ FizzyValueTypeI32, invoke_thunk_arg_types, invoke_thunk_num_args }, invoke_thunk, this };
+   FizzyExternalFunction invoke_thunk_fn = {{ FizzyValueTypeI32, invoke_thunk_arg_types, invoke_thunk_num_args }, invoke_thunk, instance.get() };
 
    FizzyExternalFn invoke_system_call = [](void* voidptr_context, FizzyInstance* fizzy_instance, const FizzyValue* args, FizzyExecutionContext* fizzy_context) noexcept -> FizzyExecutionResult
    {
-      fizzy_runner* runner = static_cast< fizzy_runner* >( voidptr_context );
-      return runner->_invoke_system_call( args, fizzy_context );
+      auto instance = static_cast< struct fizzy_instance* >( voidptr_context );
+      return instance->runner->_invoke_system_call( args, fizzy_context );
    };
 
    FizzyValueType invoke_system_call_arg_types[] = {FizzyValueTypeI32, FizzyValueTypeI32, FizzyValueTypeI32, FizzyValueTypeI32, FizzyValueTypeI32};
    size_t invoke_system_call_num_args = 5;
-   FizzyExternalFunction invoke_system_call_fn = {{ FizzyValueTypeI32, invoke_system_call_arg_types, invoke_system_call_num_args }, invoke_system_call, this };
+   FizzyExternalFunction invoke_system_call_fn = {{ FizzyValueTypeI32, invoke_system_call_arg_types, invoke_system_call_num_args }, invoke_system_call, instance.get() };
 
    size_t num_host_funcs = 2;
    FizzyImportedFunction host_funcs[] = {{"env", "invoke_thunk", invoke_thunk_fn}, {"env", "invoke_system_call", invoke_system_call_fn}};
@@ -163,14 +269,18 @@ void fizzy_runner::instantiate_module()
 
    size_t memory_pages_limit = 512;     // Number of 64k pages allowed to allocate
 
-   KOINOS_ASSERT( _instance == nullptr, runner_state_exception, "_instance was unexpectedly non-null" );
-   _instance = fizzy_resolve_instantiate(_module, host_funcs, num_host_funcs, nullptr, nullptr, nullptr, 0, memory_pages_limit, &fizzy_err);
-   if( _instance == nullptr )
+   // fizzy_resolve_instantiate takes ownership of the module, even on failure
+   instance->instance = fizzy_resolve_instantiate(module, host_funcs, num_host_funcs, nullptr, nullptr, nullptr, 0, memory_pages_limit, &fizzy_err);
+   if( instance->instance == nullptr )
    {
       std::string error_code = fizzy_error_code_name( fizzy_err.code );
       std::string error_message = fizzy_err.message;
       KOINOS_THROW( module_instantiate_exception, "could not instantiate module - ${code}: ${msg}", ("code", error_code)("msg", error_message) );
    }
+
+   instance->snapshot();
+
+   return instance;
 }
 
 FizzyExecutionResult fizzy_runner::_invoke_thunk( const FizzyValue* args, FizzyExecutionContext* fizzy_context ) noexcept
@@ -185,9 +295,9 @@ FizzyExecutionResult fizzy_runner::_invoke_thunk( const FizzyValue* args, FizzyE
    {
       uint32_t tid = args[0].i32;
       uint32_t ret_len = args[2].i32;
-      char* ret_ptr = resolve_ptr(_instance, args[1].i32, ret_len);
+      char* ret_ptr = resolve_ptr(_instance.instance, args[1].i32, ret_len);
       uint32_t arg_len = args[4].i32;
-      const char* arg_ptr = resolve_ptr(_instance, args[3].i32, arg_len);
+      const char* arg_ptr = resolve_ptr(_instance.instance, args[3].i32, arg_len);
 
       KOINOS_ASSERT( ret_ptr != nullptr, wasm_memory_exception, "invalid ret_ptr in invoke_thunk()" );
       KOINOS_ASSERT( arg_ptr != nullptr, wasm_memory_exception, "invalid arg_ptr in invoke_thunk()" );
@@ -208,13 +318,16 @@ FizzyExecutionResult fizzy_runner::_invoke_thunk( const FizzyValue* args, FizzyE
 
       _previous_ticks = _hapi.get_meter_ticks();
       *ticks = _previous_ticks;
+
+      // A successful exit traps out of the module without an exception
+      _exited = !_exception && _hapi.exit_requested();
    }
    catch ( ... )
    {
       _exception = std::current_exception();
    }
 
-   result.trapped = !!_exception;
+   result.trapped = _exception || _exited;
    return result;
 }
 
@@ -230,9 +343,9 @@ FizzyExecutionResult fizzy_runner::_invoke_system_call( const FizzyValue* args,
    {
       uint32_t xid = args[0].i32;
       uint32_t ret_len = args[2].i32;
-      char* ret_ptr = resolve_ptr(_instance, args[1].i32, ret_len);
+      char* ret_ptr = resolve_ptr(_instance.instance, args[1].i32, ret_len);
       uint32_t arg_len = args[4].i32;
-      const char* arg_ptr = resolve_ptr(_instance, args[3].i32, arg_len);
+      const char* arg_ptr = resolve_ptr(_instance.instance, args[3].i32, arg_len);
 
       KOINOS_ASSERT( ret_ptr != nullptr, wasm_memory_exception, "invalid ret_ptr in invoke_system_call()" );
       KOINOS_ASSERT( arg_ptr != nullptr, wasm_memory_exception, "invalid arg_ptr in invoke_system_call()" );
@@ -252,13 +365,16 @@ FizzyExecutionResult fizzy_runner::_invoke_system_call( const FizzyValue* args,
 
       _previous_ticks = _hapi.get_meter_ticks();
       *ticks = _previous_ticks;
+
+      // A successful exit traps out of the module without an exception
+      _exited = !_exception && _hapi.exit_requested();
    }
    catch ( ... )
    {
       _exception = std::current_exception();
    }
 
-   result.trapped = !!_exception;
+   result.trapped = _exception || _exited;
    return result;
 }
 
@@ -270,10 +386,10 @@ void fizzy_runner::call_start()
    KOINOS_ASSERT( _fizzy_context != nullptr, create_context_exception, "could not create execution context" );
 
    uint32_t start_func_idx = 0;
-   bool success = fizzy_find_exported_function_index( _module, "_start", &start_func_idx );
+   bool success = fizzy_find_exported_function_index( fizzy_get_instance_module( _instance.instance ), "_start", &start_func_idx );
    KOINOS_ASSERT( success, module_start_exception, "module does not have _start function" );
 
-   FizzyExecutionResult result = fizzy_execute( _instance, start_func_idx, nullptr, _fizzy_context );
+   FizzyExecutionResult result = fizzy_execute( _instance.instance, start_func_idx, nullptr, _fizzy_context );
 
    int64_t* ticks = fizzy_get_execution_context_ticks(_fizzy_context);
    KOINOS_ASSERT( ticks != nullptr, fizzy_returned_null_exception, "fizzy_get_execution_context_ticks() unexpectedly returned null pointer" );
@@ -286,33 +402,133 @@ void fizzy_runner::call_start()
       std::rethrow_exception( exc );
    }
 
-   if( result.trapped )
+   if( result.trapped && !_exited )
    {
       KOINOS_THROW( wasm_trap_exception, "module exited due to trap" );
    }
 }
 
+fizzy_vm_backend::fizzy_vm_backend() :
+   _cache( constants::module_cache_size ) {}
+fizzy_vm_backend::~fizzy_vm_backend() {}
+
+std::unique_ptr< fizzy_instance > fizzy_vm_backend::acquire_instance( const std::string& id )
+{
+   std::lock_guard< std::mutex > lock( _pool_mutex );
+
+   auto itr = _instance_pool.find( id );
+   if ( itr == _instance_pool.end() || itr->second.instances.empty() )
+      return nullptr;
+
+   auto instance = std::move( itr->second.instances.back() );
+   itr->second.instances.pop_back();
+   itr->second.last_used = ++_pool_clock;
+   _pool_stats.reused++;
+   return instance;
+}
+
+void fizzy_vm_backend::release_instance( const std::string& id, std::unique_ptr< fizzy_instance > instance )
+{
+   bool reset = instance->reset();
+
+   std::lock_guard< std::mutex > lock( _pool_mutex );
+
+   if ( !reset )
+   {
+      _pool_stats.discarded++;
+      return;
+   }
+
+   auto& entry = _instance_pool[ id ];
+   entry.last_used = ++_pool_clock;
+
+   if ( entry.instances.size() < constants::max_pooled_instances )
+      entry.instances.emplace_back( std::move( instance ) );
+   else
+      _pool_stats.discarded++;
+
+   if ( _instance_pool.size() > constants::max_pooled_modules )
+   {
+      auto oldest = std::min_element( _instance_pool.begin(), _instance_pool.end(), []( const auto& a, const auto& b )
+      {
+         return a.second.last_used < b.second.last_used;
+      } );
+      _instance_pool.erase( oldest );
+   }
+}
+
+instance_pool_stats fizzy_vm_backend::get_instance_pool_stats() const
+{
+   std::lock_guard< std::mutex > lock( _pool_mutex );
+   return _pool_stats;
+}
+
+void fizzy_vm_backend::prewarm( const std::string& bytecode, const std::string& id, bool pin )
+{
+   KOINOS_ASSERT( !id.empty(), null_argument_exception, "cannot prewarm a module without an id" );
+
+   if ( _cache.get_module( id ) )
+   {
+      if ( pin )
+         _cache.pin_module( id );
+
+      return;
+   }
+
+   auto start = std::chrono::steady_clock::now();
+   auto parsed_module = parse_bytecode( bytecode.data(), bytecode.size() );
+   _cache.put_module( id, parsed_module, bytecode.size(), std::chrono::steady_clock::now() - start, pin );
+}
+
 void fizzy_vm_backend::run( abstract_host_api& hapi, const std::string& bytecode, const std::string& id )
 {
-   const FizzyModule* module_ptr = nullptr;
+   if ( id.empty() )
+   {
+      auto instance = instantiate_module( parse_bytecode( bytecode.data(), bytecode.size() ) );
+      fizzy_runner runner( hapi, *instance );
+      runner.call_start();
+      return;
+   }
+
+   auto instance = acquire_instance( id );
 
-   if ( id.size() )
+   if ( !instance )
    {
-      module_ptr = _cache.get_module( id );
-      if ( !module_ptr )
+      auto cached_module = _cache.get_module( id );
+      if ( !cached_module )
       {
-         module_ptr = parse_bytecode( bytecode.data(), bytecode.size() );
-         _cache.put_module( id, module_ptr );
+         auto start = std::chrono::steady_clock::now();
+         auto parsed_module = parse_bytecode( bytecode.data(), bytecode.size() );
+         cached_module = _cache.put_module( id, parsed_module, bytecode.size(), std::chrono::steady_clock::now() - start );
       }
+
+      // Instantiation takes ownership of the module, so the instance gets its own copy of the shared module
+      auto module_ptr = fizzy_clone_module( cached_module.get() );
+      KOINOS_ASSERT( module_ptr, module_clone_exception, "failed to clone module" );
+
+      instance = instantiate_module( module_ptr );
+
+      std::lock_guard< std::mutex > lock( _pool_mutex );
+      _pool_stats.instantiated++;
    }
-   else
+
+   // The instance is returned to the pool however the contract exits
+   std::exception_ptr e;
+
+   try
+   {
+      fizzy_runner runner( hapi, *instance );
+      runner.call_start();
+   }
+   catch ( ... )
    {
-      module_ptr = module_ptr = parse_bytecode( bytecode.data(), bytecode.size() );
+      e = std::current_exception();
    }
 
-   fizzy_runner runner(hapi, module_ptr );
-   runner.instantiate_module();
-   runner.call_start();
+   release_instance( id, std::move( instance ) );
+
+   if ( e )
+      std::rethrow_exception( e );
 }
 
 } // koinos::vm_manager::fizzy
@@ -1,50 +1,127 @@
 #include <koinos/vm_manager/fizzy/module_cache.hpp>
 #include <koinos/vm_manager/fizzy/exceptions.hpp>
 
+#include <algorithm>
+
 namespace koinos::vm_manager::fizzy {
 
-module_cache::module_cache( std::size_t size ) : _cache_size( size ) {}
+module_cache::module_cache( std::size_t max_bytes ) : _max_bytes( max_bytes ) {}
+
+module_cache::~module_cache() {}
+
+module_cache::module_ptr module_cache::get_module( const std::string& id )
+{
+   std::lock_guard< std::mutex > lock( _mutex );
+
+   auto itr = _module_map.find( id );
+   if ( itr == _module_map.end() )
+      return module_ptr();
 
-module_cache::~module_cache()
+   touch( itr );
+   return itr->second.module;
+}
+
+module_cache::module_ptr module_cache::put_module( const std::string& id, const FizzyModule* module, std::size_t size, std::chrono::nanoseconds parse_time, bool pinned )
 {
-   for ( const auto& [hash, module_entry] : _module_map )
+   KOINOS_ASSERT( module != nullptr, null_argument_exception, "module was unexpectedly null pointer" );
+   module_ptr shared_module( module, []( const FizzyModule* m ) { fizzy_free_module( m ); } );
+
+   std::lock_guard< std::mutex > lock( _mutex );
+
+   if ( auto itr = _module_map.find( id ); itr != _module_map.end() )
    {
-      fizzy_free_module( module_entry.first );
+      if ( pinned )
+         pin( itr );
+      else
+         touch( itr );
+
+      return itr->second.module;
    }
+
+   size = std::max< std::size_t >( size, 1 );
+
+   // A module larger than the whole cache is used but not kept
+   if ( size > _max_bytes && !pinned )
+      return shared_module;
+
+   auto [ itr, inserted ] = _module_map.emplace( id, cache_entry{ shared_module, size, double( parse_time.count() ), 0, pinned } );
+   _size_bytes += size;
+
+   if ( !pinned )
+   {
+      itr->second.priority = _inflation + itr->second.cost / double( size );
+      _priorities.emplace( itr->second.priority, &itr->first );
+   }
+
+   evict();
+
+   return shared_module;
 }
 
-const FizzyModule* module_cache::get_module( const std::string& id )
+bool module_cache::pin_module( const std::string& id )
 {
+   std::lock_guard< std::mutex > lock( _mutex );
+
    auto itr = _module_map.find( id );
    if ( itr == _module_map.end() )
-      return nullptr;
+      return false;
 
-   // Erase the entry from the list and push front
-   _lru_list.erase( itr->second.second );
-   _lru_list.push_front( id );
-   auto module_ptr = itr->second.first;
-   _module_map[ id ] = std::make_pair( module_ptr, _lru_list.begin() );
+   pin( itr );
+   return true;
+}
+
+void module_cache::set_max_bytes( std::size_t max_bytes )
+{
+   std::lock_guard< std::mutex > lock( _mutex );
+   _max_bytes = max_bytes;
+   evict();
+}
 
-   auto cloned_module = fizzy_clone_module( module_ptr );
-   KOINOS_ASSERT( cloned_module, module_clone_exception, "failed to clone module" );
+std::size_t module_cache::size_bytes() const
+{
+   std::lock_guard< std::mutex > lock( _mutex );
+   return _size_bytes;
+}
 
-   return cloned_module;
+std::size_t module_cache::size() const
+{
+   std::lock_guard< std::mutex > lock( _mutex );
+   return _module_map.size();
 }
 
-void module_cache::put_module( const std::string& id, const FizzyModule* module )
+void module_cache::pin( module_map_type::iterator itr )
 {
-   // If the cache is full, remove the last entry from the map and pop back
-   if ( _lru_list.size() >= _cache_size )
+   if ( itr->second.pinned )
+      return;
+
+   _priorities.erase( std::make_pair( itr->second.priority, &itr->first ) );
+   itr->second.pinned = true;
+}
+
+void module_cache::touch( module_map_type::iterator itr )
+{
+   if ( itr->second.pinned )
+      return;
+
+   _priorities.erase( std::make_pair( itr->second.priority, &itr->first ) );
+   itr->second.priority = _inflation + itr->second.cost / double( itr->second.size );
+   _priorities.emplace( itr->second.priority, &itr->first );
+}
+
+void module_cache::evict()
+{
+   while ( _size_bytes > _max_bytes && !_priorities.empty() )
    {
-      _module_map.erase( _lru_list.back() );
-      _lru_list.pop_back();
-   }
+      auto lowest = _priorities.begin();
+      _inflation = lowest->first;
 
-   _lru_list.push_front( id );
+      auto itr = _module_map.find( *lowest->second );
+      _priorities.erase( lowest );
+      _size_bytes -= itr->second.size;
 
-   auto cloned_module = fizzy_clone_module( module );
-   KOINOS_ASSERT( cloned_module, module_clone_exception, "failed to clone module" );
-   _module_map[ id ] = std::make_pair( cloned_module, _lru_list.begin() );
+      // Modules still in use are freed when the last reference is released
+      _module_map.erase( itr );
+   }
 }
 
 } // koinos::vm_manager::fizzy
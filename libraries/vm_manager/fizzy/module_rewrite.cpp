@@ -0,0 +1,333 @@
+#include <koinos/vm_manager/fizzy/module_rewrite.hpp>
+
+#include <cstdint>
+#include <optional>
+#include <set>
+#include <vector>
+
+namespace koinos::vm_manager::fizzy {
+
+namespace detail {
+
+constexpr std::size_t wasm_header_size = 8;
+
+enum section_id : uint8_t
+{
+   custom_section = 0,
+   import_section = 2,
+   global_section = 6,
+   export_section = 7
+};
+
+enum external_kind : uint8_t
+{
+   function_kind = 0,
+   table_kind    = 1,
+   memory_kind   = 2,
+   global_kind   = 3
+};
+
+/**
+ * A bounds checked reader of WebAssembly binary encoding. A read past the end marks the
+ * reader as failed and returns zero.
+ */
+class wasm_reader
+{
+   public:
+      wasm_reader( const uint8_t* data, std::size_t size ) : _data( data ), _size( size ) {}
+
+      bool ok() const { return _ok; }
+      bool eof() const { return _pos >= _size; }
+      std::size_t pos() const { return _pos; }
+
+      uint8_t byte()
+      {
+         if ( !_ok || _pos >= _size )
+         {
+            _ok = false;
+            return 0;
+         }
+
+         return _data[ _pos++ ];
+      }
+
+      uint32_t u32()
+      {
+         uint32_t value = 0;
+
+         for ( uint32_t shift = 0; shift < 35; shift += 7 )
+         {
+            auto b = byte();
+            value |= uint32_t( b & 0x7f ) << shift;
+
+            if ( !( b & 0x80 ) )
+               return value;
+         }
+
+         _ok = false;
+         return 0;
+      }
+
+      // Signed integers are only skipped, their values are not needed
+      void skip_leb()
+      {
+         while ( _ok && ( byte() & 0x80 ) );
+      }
+
+      void skip( std::size_t n )
+      {
+         if ( !_ok || _size - _pos < n )
+         {
+            _ok = false;
+            return;
+         }
+
+         _pos += n;
+      }
+
+      std::string name()
+      {
+         auto length = u32();
+         auto start = _pos;
+         skip( length );
+         return _ok ? std::string( reinterpret_cast< const char* >( _data + start ), length ) : std::string();
+      }
+
+      void limits()
+      {
+         auto flags = byte();
+         u32();
+
+         if ( flags & 0x01 )
+            u32();
+      }
+
+      void constant_expression()
+      {
+         for ( auto opcode = byte(); _ok && opcode != 0x0b; opcode = byte() )
+         {
+            switch ( opcode )
+            {
+               case 0x41: // i32.const
+               case 0x42: // i64.const
+                  skip_leb();
+                  break;
+               case 0x43: // f32.const
+                  skip( 4 );
+                  break;
+               case 0x44: // f64.const
+                  skip( 8 );
+                  break;
+               case 0x23: // global.get
+               case 0xd2: // ref.func
+                  u32();
+                  break;
+               case 0xd0: // ref.null
+                  byte();
+                  break;
+               default:
+                  _ok = false;
+            }
+         }
+      }
+
+   private:
+      const uint8_t* _data;
+      std::size_t    _size;
+      std::size_t    _pos = 0;
+      bool           _ok = true;
+};
+
+void write_u32( std::string& out, uint32_t value )
+{
+   do
+   {
+      uint8_t b = value & 0x7f;
+      value >>= 7;
+
+      if ( value )
+         b |= 0x80;
+
+      out.push_back( char( b ) );
+   } while ( value );
+}
+
+struct section
+{
+   uint8_t     id;
+   std::size_t begin;   // Offset of the section id
+   std::size_t payload; // Offset of the section contents
+   std::size_t end;
+};
+
+std::optional< std::vector< section > > read_sections( const uint8_t* data, std::size_t size )
+{
+   std::vector< section > sections;
+   wasm_reader reader( data, size );
+   reader.skip( wasm_header_size );
+
+   while ( reader.ok() && !reader.eof() )
+   {
+      section s;
+      s.begin = reader.pos();
+      s.id = reader.byte();
+      auto length = reader.u32();
+      s.payload = reader.pos();
+      reader.skip( length );
+      s.end = reader.pos();
+
+      if ( reader.ok() )
+         sections.push_back( s );
+   }
+
+   if ( !reader.ok() )
+      return {};
+
+   return sections;
+}
+
+} // detail
+
+std::string export_mutable_globals( const char* bytecode_data, std::size_t bytecode_size )
+{
+   using namespace detail;
+
+   std::string bytecode( bytecode_data, bytecode_size );
+   auto data = reinterpret_cast< const uint8_t* >( bytecode_data );
+
+   if ( bytecode_size < wasm_header_size )
+      return bytecode;
+
+   auto sections = read_sections( data, bytecode_size );
+   if ( !sections )
+      return bytecode;
+
+   uint32_t imported_globals = 0;
+   std::vector< uint32_t > mutable_globals;
+   std::set< uint32_t > exported_globals;
+   std::set< std::string > export_names;
+   const section* exports = nullptr;
+   uint32_t export_count = 0;
+   std::size_t export_entries = 0;
+
+   for ( const auto& s : *sections )
+   {
+      wasm_reader reader( data + s.payload, s.end - s.payload );
+
+      switch ( s.id )
+      {
+         case import_section:
+            for ( auto count = reader.u32(); reader.ok() && count; count-- )
+            {
+               reader.name();
+               reader.name();
+
+               switch ( reader.byte() )
+               {
+                  case function_kind:
+                     reader.u32();
+                     break;
+                  case table_kind:
+                     reader.byte();
+                     reader.limits();
+                     break;
+                  case memory_kind:
+                     reader.limits();
+                     break;
+                  case global_kind:
+                     reader.skip( 2 );
+                     imported_globals++;
+                     break;
+                  default:
+                     return bytecode;
+               }
+            }
+            break;
+         case global_section:
+            for ( uint32_t i = 0, count = reader.u32(); reader.ok() && i < count; i++ )
+            {
+               reader.byte();
+
+               if ( reader.byte() )
+                  mutable_globals.push_back( imported_globals + i );
+
+               reader.constant_expression();
+            }
+            break;
+         case export_section:
+            exports = &s;
+            export_count = reader.u32();
+            export_entries = s.payload + reader.pos();
+
+            for ( auto count = export_count; reader.ok() && count; count-- )
+            {
+               export_names.insert( reader.name() );
+               auto kind = reader.byte();
+               auto index = reader.u32();
+
+               if ( kind == global_kind )
+                  exported_globals.insert( index );
+            }
+            break;
+         default:
+            break;
+      }
+
+      if ( !reader.ok() )
+         return bytecode;
+   }
+
+   std::string entries;
+   uint32_t added = 0;
+
+   for ( auto index : mutable_globals )
+   {
+      if ( exported_globals.count( index ) )
+         continue;
+
+      auto name = internal_global_export_prefix + std::to_string( index );
+      while ( export_names.count( name ) )
+         name += "_";
+
+      write_u32( entries, uint32_t( name.size() ) );
+      entries += name;
+      entries.push_back( char( global_kind ) );
+      write_u32( entries, index );
+      added++;
+   }
+
+   if ( !added )
+      return bytecode;
+
+   std::string payload;
+   write_u32( payload, export_count + added );
+
+   if ( exports )
+      payload.append( bytecode, export_entries, exports->end - export_entries );
+
+   payload += entries;
+
+   std::string section_bytes;
+   section_bytes.push_back( char( export_section ) );
+   write_u32( section_bytes, uint32_t( payload.size() ) );
+   section_bytes += payload;
+
+   if ( exports )
+      return bytecode.replace( exports->begin, exports->end - exports->begin, section_bytes );
+
+   // Without an export section, one is added ahead of the first section that must follow it
+   std::size_t insert_at = bytecode.size();
+
+   for ( const auto& s : *sections )
+   {
+      if ( s.id != custom_section && s.id > export_section )
+      {
+         insert_at = s.begin;
+         break;
+      }
+   }
+
+   return bytecode.insert( insert_at, section_bytes );
+}
+
+} // koinos::vm_manager::fizzy
@@ -5,10 +5,23 @@
 
 #include <koinos/chain/chain.pb.h>
 
+#include <map>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 
 namespace koinos::vm_manager::fizzy {
 
+struct fizzy_instance;
+
+struct instance_pool_stats
+{
+   uint64_t instantiated = 0; ///< Instances created for a run with a module id
+   uint64_t reused       = 0; ///< Runs that took a reset instance from the pool
+   uint64_t discarded    = 0; ///< Instances that could not be reset or did not fit in the pool
+};
+
 /**
  * Implementation of vm_backend for Fizzy.
  */
@@ -20,11 +33,32 @@ class fizzy_vm_backend : public vm_backend
 
       virtual std::string backend_name();
       virtual void initialize();
+      virtual void set_module_cache_size( std::size_t bytes );
+      virtual void prewarm( const std::string& bytecode, const std::string& id, bool pin = false );
 
       virtual void run( abstract_host_api& hapi, const std::string& bytecode, const std::string& id = std::string() );
 
+      instance_pool_stats get_instance_pool_stats() const;
+
    private:
-      module_cache _cache;
+      /**
+       * Instances of hot modules, reset to their post instantiation state, so a
+       * run can skip instantiation.
+       */
+      struct instance_pool_entry
+      {
+         std::vector< std::unique_ptr< fizzy_instance > > instances;
+         uint64_t                                         last_used = 0;
+      };
+
+      std::unique_ptr< fizzy_instance > acquire_instance( const std::string& id );
+      void release_instance( const std::string& id, std::unique_ptr< fizzy_instance > instance );
+
+      module_cache                                  _cache;
+      mutable std::mutex                            _pool_mutex;
+      std::map< std::string, instance_pool_entry >  _instance_pool;
+      uint64_t                                      _pool_clock = 0;
+      instance_pool_stats                           _pool_stats;
 };
 
 } // koinos::vm_manager::fizzy
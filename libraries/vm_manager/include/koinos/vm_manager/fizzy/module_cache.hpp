@@ -1,35 +1,69 @@
 #include <fizzy/fizzy.h>
 
-#include <list>
+#include <chrono>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <set>
 #include <string>
 
 namespace koinos::vm_manager::fizzy {
 
+/**
+ * A thread safe cache of parsed modules, bounded in bytes.
+ *
+ * Modules are shared and immutable, a module handed out stays valid after it is evicted.
+ * Eviction is greedy dual size: an entry's priority is the cost of parsing its module
+ * per byte, plus the priority of the last evicted entry so that entries age out. Cheap,
+ * large and cold modules are evicted first. Pinned modules are never evicted but count
+ * towards the size of the cache.
+ */
 class module_cache
 {
-   private:
-      using lru_list_type = std::list< std::string >;
+   public:
+      using module_ptr = std::shared_ptr< const FizzyModule >;
+
+      module_cache( std::size_t max_bytes );
+      ~module_cache();
 
-      using module_map_type =
-         std::map<
-            std::string,
-            std::pair<
-               const FizzyModule*,
-               typename lru_list_type::iterator
-            >
-         >;
+      module_ptr get_module( const std::string& id );
 
-      lru_list_type     _lru_list;
-      module_map_type   _module_map;
-      const std::size_t _cache_size;
+      /**
+       * Takes ownership of module, which cost parse_time to parse and is charged as size
+       * bytes. If another thread cached the module first, that module is returned instead.
+       */
+      module_ptr put_module( const std::string& id, const FizzyModule* module, std::size_t size, std::chrono::nanoseconds parse_time, bool pinned = false );
 
-   public:
-      module_cache( std::size_t size );
-      ~module_cache();
+      /** Pins a cached module, returns false if the module is not cached. */
+      bool pin_module( const std::string& id );
+
+      void set_max_bytes( std::size_t max_bytes );
+      std::size_t size_bytes() const;
+      std::size_t size() const;
+
+   private:
+      struct cache_entry
+      {
+         module_ptr  module;
+         std::size_t size;
+         double      cost;
+         double      priority;
+         bool        pinned;
+      };
+
+      using module_map_type = std::map< std::string, cache_entry >;
+      using priority_set_type = std::set< std::pair< double, const std::string* > >;
+
+      void pin( module_map_type::iterator itr );
+      void touch( module_map_type::iterator itr );
+      void evict();
 
-      const FizzyModule* get_module( const std::string& id );
-      void put_module( const std::string& id, const FizzyModule* module );
+      mutable std::mutex _mutex;
+      module_map_type    _module_map;
+      priority_set_type  _priorities;
+      double             _inflation = 0;
+      std::size_t        _size_bytes = 0;
+      std::size_t        _max_bytes;
 };
 
 } // koinos::vm_manager::fizzy
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace koinos::vm_manager::fizzy {
+
+/**
+ * Prefix of the names under which export_mutable_globals() exports internal globals.
+ */
+constexpr const char* internal_global_export_prefix = "__koinos_global_";
+
+/**
+ * Returns the bytecode with every mutable global defined by the module exported.
+ *
+ * Fizzy's C API only reaches exported globals, so internal globals, such as the stack pointer
+ * of an AssemblyScript module, are exported under internal_global_export_prefix followed by
+ * their index so that an instance can be restored to its post instantiation state. Exports are
+ * only visible to the host, the behavior of the module is unchanged.
+ *
+ * Bytecode that cannot be decoded is returned unchanged, leaving the error to the parser.
+ */
+std::string export_mutable_globals( const char* bytecode_data, std::size_t bytecode_size );
+
+} // koinos::vm_manager::fizzy
@@ -19,6 +19,12 @@ class abstract_host_api
       virtual uint32_t invoke_system_call( uint32_t xid, char* ret_ptr, uint32_t ret_len, const char* arg_ptr, uint32_t arg_len ) = 0;
       virtual int64_t get_meter_ticks()const = 0;
       virtual void use_meter_ticks( uint64_t meter_ticks ) = 0;
+
+      /**
+       * True once the running contract has exited successfully. Backends check it after each
+       * host call and end the run normally, so a successful exit does not throw.
+       */
+      virtual bool exit_requested() const = 0;
 };
 
 } // koinos::vm_manager
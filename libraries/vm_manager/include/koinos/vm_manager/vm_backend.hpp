@@ -27,6 +27,17 @@ class vm_backend
        */
       virtual void initialize() = 0;
 
+      /**
+       * Set the maximum size, in bytes, of the cache of parsed modules.
+       */
+      virtual void set_module_cache_size( std::size_t bytes ) = 0;
+
+      /**
+       * Parse and cache the module of some bytecode ahead of its first run.
+       * A pinned module is never evicted from the cache.
+       */
+      virtual void prewarm( const std::string& bytecode, const std::string& id, bool pin = false ) = 0;
+
       /**
        * Run some bytecode.
        */
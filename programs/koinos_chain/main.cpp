@@ -1,11 +1,16 @@
 #include <cstdlib>
 #include <filesystem>
 #include <fstream>
+#include <future>
 #include <iostream>
+#include <optional>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include <boost/asio.hpp>
 #include <boost/asio/signal_set.hpp>
+#include <boost/asio/thread_pool.hpp>
 #include <boost/program_options.hpp>
 #include <boost/thread/sync_bounded_queue.hpp>
 
@@ -15,6 +20,7 @@
 
 #include <koinos/chain/constants.hpp>
 #include <koinos/chain/controller.hpp>
+#include <koinos/chain/prevalidation.hpp>
 #include <koinos/chain/state.hpp>
 #include <koinos/crypto/multihash.hpp>
 #include <koinos/exception.hpp>
@@ -28,6 +34,7 @@
 
 #include <koinos/util/base58.hpp>
 #include <koinos/util/conversion.hpp>
+#include <koinos/util/hex.hpp>
 #include <koinos/util/options.hpp>
 #include <koinos/util/random.hpp>
 #include <koinos/util/services.hpp>
@@ -52,6 +59,12 @@
 #define GENESIS_DATA_FILE_DEFAULT           "genesis_data.json"
 #define READ_COMPUTE_BANDWITH_LIMIT_OPTION  "read-compute-bandwidth-limit"
 #define READ_COMPUTE_BANDWITH_LIMIT_DEFAULT 10'000'000
+#define TRUSTED_CHECKPOINT_HEIGHT_OPTION    "trusted-checkpoint-height"
+#define TRUSTED_CHECKPOINT_ID_OPTION        "trusted-checkpoint-id"
+#define MODULE_CACHE_SIZE_OPTION            "module-cache-size"
+#define MODULE_CACHE_SIZE_DEFAULT           64
+#define HOT_CONTRACTS_OPTION                "hot-contracts"
+#define VM_OPTION                           "vm"
 
 using namespace boost;
 using namespace koinos;
@@ -218,10 +231,23 @@ void attach_request_handler(
 }
 
 
-void index_loop(
-   chain::controller& controller,
+struct prevalidated_block
+{
+   rpc::chain::submit_block_request                request;
+   std::shared_ptr< const chain::prevalidation_cache > prevalidation;
+};
+
+using prevalidated_block_future = std::shared_future< prevalidated_block >;
+
+/**
+ * Parses block batches from the block store and schedules the stateless validation
+ * of each block on the worker pool. The futures are queued in block order.
+ */
+void prevalidate_loop(
+   asio::thread_pool& pool,
    concurrent::sync_bounded_queue< std::shared_future< std::string > >& rpc_queue,
-   uint64_t last_height )
+   concurrent::sync_bounded_queue< prevalidated_block_future >& block_queue,
+   crypto::multicodec hash_code )
 {
    while ( true )
    {
@@ -237,21 +263,21 @@ void index_loop(
 
       try
       {
-         rpc::block_store::block_store_response resp;
+         auto resp = std::make_shared< rpc::block_store::block_store_response >();
          rpc::block_store::get_blocks_by_height_response* batch = nullptr;
 
-         if ( resp.ParseFromString( future.get() ) )
+         if ( resp->ParseFromString( future.get() ) )
          {
-            switch( resp.response_case() )
+            switch( resp->response_case() )
             {
                case rpc::block_store::block_store_response::ResponseCase::kGetBlocksByHeight:
                {
-                  batch = resp.mutable_get_blocks_by_height();
+                  batch = resp->mutable_get_blocks_by_height();
                   break;
                }
                case rpc::block_store::block_store_response::ResponseCase::kError:
                {
-                  KOINOS_THROW( chain::rpc_failure, resp.error().message() );
+                  KOINOS_THROW( chain::rpc_failure, resp->error().message() );
                   break;
                }
                default:
@@ -262,12 +288,19 @@ void index_loop(
             }
          }
 
-         rpc::chain::submit_block_request sub_block;
-
          for ( auto& block_item : *batch->mutable_block_items() )
          {
-            sub_block.set_allocated_block( block_item.release_block() );
-            controller.submit_block( sub_block, last_height );
+            auto pb = std::make_shared< prevalidated_block >();
+            pb->request.set_allocated_block( block_item.release_block() );
+
+            auto task = std::make_shared< std::packaged_task< prevalidated_block() > >( [pb, hash_code]()
+            {
+               pb->prevalidation = chain::prevalidate_block( pb->request.block(), hash_code );
+               return std::move( *pb );
+            } );
+
+            block_queue.push_back( task->get_future().share() );
+            asio::post( pool, [task]() { ( *task )(); } );
          }
       }
       catch ( const boost::exception& e )
@@ -281,14 +314,124 @@ void index_loop(
          exit( EXIT_FAILURE );
       }
    }
+
+   block_queue.close();
 }
 
-void index( chain::controller& controller, std::shared_ptr< mq::client > mq_client )
+/**
+ * Applies prevalidated blocks to state in block order. The next block is submitted as
+ * soon as the previous one has been applied, so committing and publishing a block
+ * overlap with the application of the next.
+ */
+void index_loop(
+   chain::controller& controller,
+   concurrent::sync_bounded_queue< prevalidated_block_future >& block_queue,
+   uint64_t last_height )
+{
+   std::optional< chain::block_submission > previous;
+
+   while ( true )
+   {
+      prevalidated_block_future future;
+      try
+      {
+         block_queue.pull_front( future );
+      }
+      catch ( const concurrent::sync_queue_is_closed& )
+      {
+         try
+         {
+            if ( previous )
+               previous->published.get();
+         }
+         catch ( const std::exception& e )
+         {
+            LOG(error) << "Index error: " << e.what();
+            exit( EXIT_FAILURE );
+         }
+
+         break;
+      }
+
+      try
+      {
+         const auto& block = future.get();
+         auto submission = controller.async_submit_block( block.request, last_height, std::chrono::system_clock::now(), block.prevalidation );
+
+         if ( previous )
+            previous->committed.get();
+
+         submission.applied.get();
+         previous = std::move( submission );
+      }
+      catch ( const boost::exception& e )
+      {
+         LOG(error) << "Index error: " << boost::diagnostic_information( e );
+         exit( EXIT_FAILURE );
+      }
+      catch ( const std::exception& e )
+      {
+         LOG(error) << "Index error: " << e.what();
+         exit( EXIT_FAILURE );
+      }
+   }
+}
+
+using trusted_checkpoint = std::pair< uint64_t, crypto::multihash >;
+
+/**
+ * Links the blocks between the head and the trusted checkpoint to the checkpoint by walking the
+ * ancestry of the checkpoint block down to the head. Only ids are requested, the blocks themselves
+ * are fetched once by the sync loop. Only linked blocks skip signature verification.
+ */
+void link_trusted_checkpoint( chain::controller& controller, std::shared_ptr< mq::client > mq_client, uint64_t head_height, const trusted_checkpoint& checkpoint )
+{
+   using namespace rpc::block_store;
+
+   constexpr uint64_t batch_size = 1000;
+   const auto before = std::chrono::system_clock::now();
+
+   LOG(info) << "Linking blocks from height " << head_height + 1 << " to the trusted checkpoint at height " << checkpoint.first;
+
+   auto top = checkpoint.first;
+
+   while ( top > head_height )
+   {
+      auto start = top - head_height > batch_size ? top - batch_size + 1 : head_height + 1;
+
+      block_store_request req;
+      auto* by_height_req = req.mutable_get_blocks_by_height();
+      by_height_req->set_head_block_id( util::converter::as< std::string >( checkpoint.second ) );
+      by_height_req->set_ancestor_start_height( start );
+      by_height_req->set_num_blocks( top - start + 1 );
+      by_height_req->set_return_block( false );
+      by_height_req->set_return_receipt( false );
+
+      block_store_response resp;
+      KOINOS_ASSERT( resp.ParseFromString( mq_client->rpc( util::service::block_store, util::converter::as< std::string >( req ) ).get() ), chain::rpc_failure, "unable to parse block store response" );
+      KOINOS_ASSERT( !resp.has_error(), chain::rpc_failure, resp.error().message() );
+      KOINOS_ASSERT( resp.has_get_blocks_by_height(), chain::rpc_failure, "unexpected block store response" );
+
+      const auto& items = resp.get_blocks_by_height().block_items();
+      KOINOS_ASSERT( items.size() == int( top - start + 1 ), chain::rpc_failure, "block store is missing blocks below the trusted checkpoint" );
+
+      for ( auto itr = items.rbegin(); itr != items.rend(); ++itr )
+         controller.link_trusted_block( itr->block_height(), util::converter::to< crypto::multihash >( itr->block_id() ) );
+
+      top = start - 1;
+   }
+
+   const std::chrono::duration< double > duration = std::chrono::system_clock::now() - before;
+   LOG(info) << "Linked " << checkpoint.first - head_height << " blocks to the trusted checkpoint, took " << duration.count() << " seconds";
+}
+
+void index( chain::controller& controller, std::shared_ptr< mq::client > mq_client, uint64_t jobs, const std::optional< trusted_checkpoint >& checkpoint )
 {
    using namespace rpc::block_store;
    try
    {
       constexpr uint64_t batch_size = 1000;
+      constexpr std::size_t prevalidation_queue_size = 2000;
       const auto before = std::chrono::system_clock::now();
 
       LOG(info) << "Retrieving highest block from block store";
@@ -330,15 +473,31 @@ void index( chain::controller& controller, std::shared_ptr< mq::client > mq_clie
 
       auto head_info = controller.get_head_info();
 
+      if ( checkpoint && head_info.head_topology().height() < checkpoint->first )
+      {
+         if ( target_head.height() < checkpoint->first )
+            LOG(warning) << "Block store does not reach the trusted checkpoint at height " << checkpoint->first << ", all block signatures will be verified";
+         else
+            link_trusted_checkpoint( controller, mq_client, head_info.head_topology().height(), *checkpoint );
+      }
+
       if ( head_info.head_topology().height() < target_head.height() )
       {
          LOG(info) << "Indexing to target block: " << target_head;
 
          concurrent::sync_bounded_queue< std::shared_future< std::string > > rpc_queue{ 10 };
+         concurrent::sync_bounded_queue< prevalidated_block_future > block_queue{ prevalidation_queue_size };
+         asio::thread_pool prevalidation_pool( jobs );
+         auto hash_code = controller.get_block_hash_code();
+
+         auto prevalidate_thread = std::make_unique< std::thread >( [&]()
+         {
+            prevalidate_loop( prevalidation_pool, rpc_queue, block_queue, hash_code );
+         } );
 
          auto index_thread = std::make_unique< std::thread >( [&]()
          {
-            index_loop( controller, rpc_queue, target_head.height() );
+            index_loop( controller, block_queue, target_head.height() );
          } );
 
          crypto::multihash last_id = crypto::multihash::zero( crypto::multicodec::sha2_256 );
@@ -359,7 +518,9 @@ void index( chain::controller& controller, std::shared_ptr< mq::client > mq_clie
          }
 
          rpc_queue.close();
+         prevalidate_thread->join();
          index_thread->join();
+         prevalidation_pool.join();
 
          auto new_head_info = controller.get_head_info();
 
@@ -392,7 +553,14 @@ int main( int argc, char** argv )
          (GENESIS_DATA_FILE_OPTION          ",g", program_options::value< std::string >(), "The genesis data file")
          (STATEDIR_OPTION                       , program_options::value< std::string >(),
             "The location of the blockchain state files (absolute path or relative to basedir/chain)")
-         (RESET_OPTION                          , program_options::bool_switch()->default_value(false), "Reset the database");
+         (RESET_OPTION                          , program_options::bool_switch()->default_value(false), "Reset the database")
+         (TRUSTED_CHECKPOINT_HEIGHT_OPTION      , program_options::value< uint64_t    >(),
+            "Skip block signature verification while indexing up to this height")
+         (TRUSTED_CHECKPOINT_ID_OPTION          , program_options::value< std::string >(), "The hex encoded ID of the block at the trusted checkpoint height")
+         (MODULE_CACHE_SIZE_OPTION              , program_options::value< uint64_t    >(), "The size of the parsed contract module cache in MiB")
+         (HOT_CONTRACTS_OPTION                  , program_options::value< std::vector< std::string > >()->multitoken(),
+            "Base58 encoded contract IDs whose modules are parsed at startup and never evicted")
+         (VM_OPTION                             , program_options::value< std::string >(), "The VM backend to use");
 
       program_options::variables_map args;
       program_options::store( program_options::parse_command_line( argc, argv, options ), args );
@@ -442,10 +610,20 @@ int main( int argc, char** argv )
       auto reset                = util::get_flag( RESET_OPTION, false, args, chain_config, global_config );
       auto jobs                 = util::get_option< uint64_t >( JOBS_OPTION, std::thread::hardware_concurrency(), args, chain_config, global_config );
       auto read_compute_limit   = util::get_option< uint64_t >( READ_COMPUTE_BANDWITH_LIMIT_OPTION, READ_COMPUTE_BANDWITH_LIMIT_DEFAULT, args, chain_config, global_config );
+      auto checkpoint_height    = util::get_option< uint64_t >( TRUSTED_CHECKPOINT_HEIGHT_OPTION, 0, args, chain_config, global_config );
+      auto checkpoint_id        = util::get_option< std::string >( TRUSTED_CHECKPOINT_ID_OPTION, "", args, chain_config, global_config );
+      auto module_cache_size    = util::get_option< uint64_t >( MODULE_CACHE_SIZE_OPTION, MODULE_CACHE_SIZE_DEFAULT, args, chain_config, global_config );
+      auto hot_contracts        = util::get_options< std::string >( HOT_CONTRACTS_OPTION, args, chain_config, global_config );
+      auto vm_backend_name      = util::get_option< std::string >( VM_OPTION, vm_manager::get_default_vm_backend_name(), args, chain_config, global_config );
 
       koinos::initialize_logging( util::service::chain, instance_id, log_level, basedir / util::service::chain );
 
       KOINOS_ASSERT( jobs > 0, koinos::exception, "jobs must be greater than 0" );
+      KOINOS_ASSERT(
+         ( checkpoint_height == 0 ) == checkpoint_id.empty(),
+         koinos::exception,
+         "${h} and ${i} must be specified together", ("h", TRUSTED_CHECKPOINT_HEIGHT_OPTION)("i", TRUSTED_CHECKPOINT_ID_OPTION)
+      );
 
       if ( config.IsNull() )
       {
@@ -484,9 +662,26 @@ int main( int argc, char** argv )
       LOG(info) << "Chain ID: " << chain_id;
       LOG(info) << "Number of jobs: " << jobs;
 
-      chain::controller controller( read_compute_limit );
+      LOG(info) << "VM backend: " << vm_backend_name;
+
+      chain::controller controller( read_compute_limit, vm_backend_name );
+      controller.set_module_cache_size( module_cache_size * 1024 * 1024 );
+
+      std::vector< std::string > hot_contract_ids;
+      for ( const auto& contract : hot_contracts )
+         hot_contract_ids.emplace_back( util::from_base58< std::string >( contract ) );
+
+      controller.set_hot_contracts( hot_contract_ids );
       controller.open( statedir, genesis_data, reset );
 
+      std::optional< trusted_checkpoint > checkpoint;
+
+      if ( checkpoint_height )
+      {
+         checkpoint.emplace( checkpoint_height, util::converter::to< crypto::multihash >( util::from_hex< std::string >( checkpoint_id ) ) );
+         controller.set_trusted_checkpoint( checkpoint->first, checkpoint->second );
+      }
+
       asio::io_context main_context, work_context;
       auto mq_client = std::make_shared< mq::client >();
       auto request_handler = mq::request_handler( work_context );
@@ -513,7 +708,7 @@ int main( int argc, char** argv )
       mq_client->rpc( util::service::mempool, result ).get();
       LOG(info) << "Established connection to mempool";
 
-      index( controller, mq_client );
+      index( controller, mq_client, jobs, checkpoint );
       controller.set_client( mq_client );
 
       attach_request_handler( controller, request_handler, amqp_url );
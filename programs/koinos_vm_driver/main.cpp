@@ -26,7 +26,7 @@ int main( int argc, char** argv, char** envp )
       desc.add_options()
         ( HELP_OPTION ",h", "print usage message" )
         ( CONTRACT_OPTION ",c", boost::program_options::value< std::string >(), "the contract to run" )
-        ( VM_OPTION ",v", boost::program_options::value< std::string >()->default_value( "" ), "the VM backend to use" )
+        ( VM_OPTION ",v", boost::program_options::value< std::string >()->default_value( vm_manager::get_default_vm_backend_name() ), "the VM backend to use" )
         ( TICKS_OPTION ",t", boost::program_options::value< int64_t >()->default_value( 10 * 1000 * 1000 ), "set maximum allowed ticks" )
         ( LIST_VM_OPTION ",l", "list available VM backends" )
         ;
@@ -44,7 +44,7 @@ int main( int argc, char** argv, char** envp )
 
       if ( vmap.count( LIST_VM_OPTION ) )
       {
-         std::cout << "Available VM Backend(s):";
+         std::cout << "Available VM Backend(s):" << std::endl;
 
          std::vector< std::shared_ptr< vm_manager::vm_backend > > backends = vm_manager::get_vm_backends();
          for( auto b : backends )
@@ -70,7 +70,7 @@ int main( int argc, char** argv, char** envp )
       std::string vm_backend_name = vmap[ VM_OPTION ].as< std::string >();
 
       auto vm_backend = vm_manager::get_vm_backend( vm_backend_name );
-      KOINOS_ASSERT( vm_backend, koinos::chain::unknown_backend_exception, "Couldn't get VM backend" );
+      KOINOS_ASSERT( vm_backend, koinos::chain::unknown_backend_exception, "Couldn't get VM backend ${b}", ("b", vm_backend_name) );
 
       vm_backend->initialize();
       LOG(info) << "Initialized " << vm_backend->backend_name() << " VM backend";
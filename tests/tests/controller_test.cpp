@@ -6,6 +6,7 @@
 #include <koinos/chain/constants.hpp>
 #include <koinos/chain/controller.hpp>
 #include <koinos/chain/exceptions.hpp>
+#include <koinos/chain/prevalidation.hpp>
 #include <koinos/chain/state.hpp>
 #include <koinos/chain/system_calls.hpp>
 #include <koinos/crypto/multihash.hpp>
@@ -19,6 +20,7 @@
 
 #include <chrono>
 #include <filesystem>
+#include <mutex>
 #include <sstream>
 
 using namespace koinos;
@@ -982,4 +984,284 @@ BOOST_AUTO_TEST_CASE( system_call_override_test )
    BOOST_REQUIRE_EQUAL( contract_response.logs( 0 ), "test: Greetings from koinos vm" );
 
 } KOINOS_CATCH_LOG_AND_RETHROW(info) }
+BOOST_AUTO_TEST_CASE( prevalidation_test )
+{ try {
+   BOOST_TEST_MESSAGE( "Prevalidate a block with a transaction" );
+
+   auto alice_private_key = koinos::crypto::private_key::regenerate( koinos::crypto::hash( koinos::crypto::multicodec::sha2_256, "alice"s ) );
+
+   koinos::chain::value_type nonce_value;
+   nonce_value.set_uint64_value( 1 );
+
+   koinos::protocol::transaction trx;
+   trx.mutable_header()->set_rc_limit( 1'000'000 );
+   trx.mutable_header()->set_chain_id( _controller.get_chain_id().chain_id() );
+   trx.mutable_header()->set_nonce( util::converter::as< std::string >( nonce_value ) );
+   set_transaction_merkle_roots( trx, koinos::crypto::multicodec::sha2_256 );
+   sign_transaction( trx, alice_private_key );
+
+   koinos::rpc::chain::submit_block_request block_req;
+
+   auto duration = std::chrono::system_clock::now().time_since_epoch();
+   block_req.mutable_block()->mutable_header()->set_timestamp( std::chrono::duration_cast< std::chrono::milliseconds >( duration ).count() );
+   block_req.mutable_block()->mutable_header()->set_height( 1 );
+   block_req.mutable_block()->mutable_header()->set_previous( util::converter::as< std::string >( koinos::crypto::multihash::zero( koinos::crypto::multicodec::sha2_256 ) ) );
+   block_req.mutable_block()->mutable_header()->set_previous_state_merkle_root( _controller.get_head_info().head_state_merkle_root() );
+   *block_req.mutable_block()->add_transactions() = trx;
+
+   set_block_merkle_roots( *block_req.mutable_block(), koinos::crypto::multicodec::sha2_256 );
+   block_req.mutable_block()->set_id( util::converter::as< std::string >( koinos::crypto::hash( koinos::crypto::multicodec::sha2_256, block_req.block().header() ) ) );
+   sign_block( *block_req.mutable_block(), _block_signing_private_key );
+
+   auto prevalidation = chain::prevalidate_block( block_req.block(), koinos::crypto::multicodec::sha2_256 );
+
+   BOOST_REQUIRE( prevalidation );
+   BOOST_REQUIRE_EQUAL( prevalidation->size(), 2 );
+
+   auto block_signer = prevalidation->find( block_req.block().signature(), block_req.block().id() );
+   BOOST_REQUIRE( block_signer );
+   BOOST_CHECK( util::converter::to< crypto::public_key >( *block_signer ).to_address_bytes() == _block_signing_private_key.get_public_key().to_address_bytes() );
+
+   auto trx_signer = prevalidation->find( trx.signatures( 0 ), trx.id() );
+   BOOST_REQUIRE( trx_signer );
+   BOOST_CHECK( util::converter::to< crypto::public_key >( *trx_signer ).to_address_bytes() == alice_private_key.get_public_key().to_address_bytes() );
+
+   const auto hash_code = std::underlying_type_t< koinos::crypto::multicodec >( koinos::crypto::multicodec::sha2_256 );
+   auto block_hash = prevalidation->find_hash( hash_code, util::converter::as< std::string >( block_req.block().header() ) );
+   BOOST_REQUIRE( block_hash );
+   BOOST_CHECK( *block_hash == block_req.block().id() );
+
+   auto trx_hash = prevalidation->find_hash( hash_code, util::converter::as< std::string >( trx.header() ) );
+   BOOST_REQUIRE( trx_hash );
+   BOOST_CHECK( *trx_hash == trx.id() );
+
+   BOOST_CHECK( !prevalidation->verified_merkle_root( block_req.block().header().transaction_merkle_root(), {} ) );
+
+   BOOST_TEST_MESSAGE( "Cached results are not found for the same bytes split differently" );
+
+   const auto& tx_root = block_req.block().header().transaction_merkle_root();
+   auto sig_hash = util::converter::as< std::string >( koinos::crypto::hash( koinos::crypto::multicodec::sha2_256, trx.signatures( 0 ) ) );
+   BOOST_REQUIRE( prevalidation->verified_merkle_root( tx_root, { trx.id(), sig_hash } ) );
+   BOOST_CHECK( !prevalidation->verified_merkle_root( tx_root, { trx.id() + sig_hash } ) );
+   BOOST_CHECK( !prevalidation->verified_merkle_root( tx_root, { trx.id() + sig_hash.substr( 0, 1 ), sig_hash.substr( 1 ) } ) );
+   BOOST_CHECK( !prevalidation->verified_merkle_root( tx_root + trx.id(), { sig_hash } ) );
+
+   BOOST_CHECK( !prevalidation->find( trx.signatures( 0 ).substr( 0, 64 ), trx.signatures( 0 ).substr( 64 ) + trx.id() ) );
+   BOOST_CHECK( !prevalidation->find_hash( hash_code, util::converter::as< std::string >( trx.header() ) + "x" ) );
+
+   BOOST_TEST_MESSAGE( "Error when the block id does not match" );
+
+   auto bad_block = block_req.block();
+   bad_block.set_id( util::converter::as< std::string >( koinos::crypto::hash( koinos::crypto::multicodec::sha2_256, "bad id"s ) ) );
+   BOOST_CHECK_THROW( chain::prevalidate_block( bad_block, koinos::crypto::multicodec::sha2_256 ), chain::block_id_mismatch );
+
+   BOOST_TEST_MESSAGE( "Error when the transaction merkle root does not match" );
+
+   bad_block = block_req.block();
+   bad_block.mutable_transactions( 0 )->add_signatures( trx.signatures( 0 ) );
+   BOOST_CHECK_THROW( chain::prevalidate_block( bad_block, koinos::crypto::multicodec::sha2_256 ), chain::transaction_root_mismatch );
+
+   BOOST_TEST_MESSAGE( "Error when the operation merkle root does not match" );
+
+   bad_block = block_req.block();
+   bad_block.mutable_transactions( 0 )->add_operations()->mutable_call_contract()->set_entry_point( 1 );
+   BOOST_CHECK_THROW( chain::prevalidate_block( bad_block, koinos::crypto::multicodec::sha2_256 ), chain::operation_root_mismatch );
+
+   BOOST_TEST_MESSAGE( "Error when the block does not use the chain's hash code" );
+
+   BOOST_CHECK_THROW( chain::prevalidate_block( block_req.block(), koinos::crypto::multicodec::sha2_512 ), chain::block_id_mismatch );
+
+   BOOST_TEST_MESSAGE( "Submit the prevalidated block" );
+
+   auto block_resp = _controller.submit_block( block_req, 0, std::chrono::system_clock::now(), prevalidation );
+   BOOST_REQUIRE_EQUAL( block_resp.receipt().id(), block_req.block().id() );
+   BOOST_REQUIRE_EQUAL( block_resp.receipt().transaction_receipts_size(), 1 );
+
+} KOINOS_CATCH_LOG_AND_RETHROW(info) }
+
+BOOST_AUTO_TEST_CASE( async_submission_test )
+{ try {
+   BOOST_TEST_MESSAGE( "Submit a block asynchronously and observe its stages" );
+
+   koinos::rpc::chain::submit_block_request block_req;
+
+   auto duration = std::chrono::system_clock::now().time_since_epoch();
+   block_req.mutable_block()->mutable_header()->set_timestamp( std::chrono::duration_cast< std::chrono::milliseconds >( duration ).count() );
+   block_req.mutable_block()->mutable_header()->set_height( 1 );
+   block_req.mutable_block()->mutable_header()->set_previous( util::converter::as< std::string >( koinos::crypto::multihash::zero( koinos::crypto::multicodec::sha2_256 ) ) );
+   block_req.mutable_block()->mutable_header()->set_previous_state_merkle_root( _controller.get_head_info().head_state_merkle_root() );
+
+   set_block_merkle_roots( *block_req.mutable_block(), koinos::crypto::multicodec::sha2_256 );
+   block_req.mutable_block()->set_id( util::converter::as< std::string >( koinos::crypto::hash( koinos::crypto::multicodec::sha2_256, block_req.block().header() ) ) );
+   sign_block( *block_req.mutable_block(), _block_signing_private_key );
+
+   std::mutex stages_mutex;
+   std::vector< chain::submission_stage > stages;
+
+   auto submission = _controller.async_submit_block( block_req, 0, std::chrono::system_clock::now(), nullptr, [&]( chain::submission_stage stage )
+   {
+      std::lock_guard< std::mutex > lock( stages_mutex );
+      stages.push_back( stage );
+   } );
+
+   submission.validated.get();
+   submission.applied.get();
+   auto block_resp = submission.committed.get();
+   submission.published.get();
+
+   BOOST_REQUIRE_EQUAL( block_resp.receipt().id(), block_req.block().id() );
+   BOOST_REQUIRE_EQUAL( _controller.get_head_info().head_topology().id(), block_req.block().id() );
+
+   {
+      std::lock_guard< std::mutex > lock( stages_mutex );
+      std::vector< chain::submission_stage > expected_stages {
+         chain::submission_stage::validated,
+         chain::submission_stage::applied,
+         chain::submission_stage::committed,
+         chain::submission_stage::published
+      };
+      BOOST_CHECK( stages == expected_stages );
+   }
+
+   BOOST_TEST_MESSAGE( "Failed submissions propagate the error to every stage" );
+
+   block_req.mutable_block()->mutable_header()->set_height( 3 );
+   block_req.mutable_block()->mutable_header()->set_previous( block_req.block().id() );
+   block_req.mutable_block()->set_id( util::converter::as< std::string >( koinos::crypto::hash( koinos::crypto::multicodec::sha2_256, block_req.block().header() ) ) );
+   sign_block( *block_req.mutable_block(), _block_signing_private_key );
+
+   submission = _controller.async_submit_block( block_req );
+
+   BOOST_CHECK_THROW( submission.validated.get(), chain::unexpected_height );
+   BOOST_CHECK_THROW( submission.applied.get(), chain::unexpected_height );
+   BOOST_CHECK_THROW( submission.committed.get(), chain::unexpected_height );
+   BOOST_CHECK_THROW( submission.published.get(), chain::unexpected_height );
+
+   BOOST_TEST_MESSAGE( "A block with an invalid signature is never validated" );
+
+   auto foo_key = koinos::crypto::private_key::regenerate( koinos::crypto::hash( koinos::crypto::multicodec::sha2_256, "foo"s ) );
+
+   block_req.mutable_block()->mutable_header()->set_height( 2 );
+   block_req.mutable_block()->mutable_header()->set_previous_state_merkle_root( _controller.get_head_info().head_state_merkle_root() );
+   block_req.mutable_block()->set_id( util::converter::as< std::string >( koinos::crypto::hash( koinos::crypto::multicodec::sha2_256, block_req.block().header() ) ) );
+   sign_block( *block_req.mutable_block(), foo_key );
+
+   submission = _controller.async_submit_block( block_req );
+
+   BOOST_CHECK_THROW( submission.validated.get(), chain::invalid_block_signature );
+   BOOST_CHECK_THROW( submission.committed.get(), chain::invalid_block_signature );
+
+} KOINOS_CATCH_LOG_AND_RETHROW(info) }
+
+BOOST_AUTO_TEST_CASE( trusted_checkpoint_test )
+{ try {
+   BOOST_TEST_MESSAGE( "Error when block at the checkpoint height does not match the checkpoint" );
+
+   auto foo_key = koinos::crypto::private_key::regenerate( koinos::crypto::hash( koinos::crypto::multicodec::sha2_256, "foo"s ) );
+
+   koinos::rpc::chain::submit_block_request block_req;
+
+   auto duration = std::chrono::system_clock::now().time_since_epoch();
+   block_req.mutable_block()->mutable_header()->set_timestamp( std::chrono::duration_cast< std::chrono::milliseconds >( duration ).count() );
+   block_req.mutable_block()->mutable_header()->set_height( 1 );
+   block_req.mutable_block()->mutable_header()->set_previous( util::converter::as< std::string >( koinos::crypto::multihash::zero( koinos::crypto::multicodec::sha2_256 ) ) );
+   block_req.mutable_block()->mutable_header()->set_previous_state_merkle_root( _controller.get_head_info().head_state_merkle_root() );
+   block_req.mutable_block()->mutable_header()->set_signer( util::converter::as< std::string >( foo_key.get_public_key().to_address_bytes() ) );
+
+   set_block_merkle_roots( *block_req.mutable_block(), koinos::crypto::multicodec::sha2_256 );
+   block_req.mutable_block()->set_id( util::converter::as< std::string >( koinos::crypto::hash( koinos::crypto::multicodec::sha2_256, block_req.block().header() ) ) );
+   sign_block( *block_req.mutable_block(), foo_key );
+
+   _controller.set_trusted_checkpoint( 1, koinos::crypto::multihash::empty( koinos::crypto::multicodec::sha2_256 ) );
+   BOOST_CHECK_THROW( _controller.submit_block( block_req, 1 ), chain::checkpoint_mismatch );
+
+   BOOST_TEST_MESSAGE( "Block signatures are verified until the block is linked to the trusted checkpoint" );
+
+   _controller.set_trusted_checkpoint( 1, util::converter::to< koinos::crypto::multihash >( block_req.block().id() ) );
+   BOOST_CHECK_THROW( _controller.submit_block( block_req, 1 ), chain::invalid_block_signature );
+
+   BOOST_TEST_MESSAGE( "Error when a block id does not link to the trusted checkpoint" );
+
+   BOOST_CHECK_THROW( _controller.link_trusted_block( 1, koinos::crypto::multihash::empty( koinos::crypto::multicodec::sha2_256 ) ), chain::checkpoint_mismatch );
+   BOOST_CHECK_THROW( _controller.link_trusted_block( 0, util::converter::to< koinos::crypto::multihash >( block_req.block().id() ) ), chain::unexpected_height );
+
+   BOOST_TEST_MESSAGE( "Block signatures are not verified for linked blocks while indexing" );
+
+   _controller.link_trusted_block( 1, util::converter::to< koinos::crypto::multihash >( block_req.block().id() ) );
+   BOOST_CHECK_THROW( _controller.submit_block( block_req ), chain::invalid_block_signature );
+
+   auto block_resp = _controller.submit_block( block_req, 1 );
+   BOOST_REQUIRE_EQUAL( block_resp.receipt().id(), block_req.block().id() );
+
+   BOOST_TEST_MESSAGE( "Block signatures are verified past the trusted checkpoint" );
+
+   block_req.mutable_block()->mutable_header()->set_height( 2 );
+   block_req.mutable_block()->mutable_header()->set_previous( block_req.block().id() );
+   block_req.mutable_block()->mutable_header()->set_previous_state_merkle_root( _controller.get_head_info().head_state_merkle_root() );
+   block_req.mutable_block()->set_id( util::converter::as< std::string >( koinos::crypto::hash( koinos::crypto::multicodec::sha2_256, block_req.block().header() ) ) );
+   sign_block( *block_req.mutable_block(), foo_key );
+
+   BOOST_CHECK_THROW( _controller.submit_block( block_req, 2 ), chain::invalid_block_signature );
+
+} KOINOS_CATCH_LOG_AND_RETHROW(info) }
+
+BOOST_AUTO_TEST_CASE( deferred_merkle_root_test )
+{ try {
+   BOOST_TEST_MESSAGE( "The state merkle root of an indexed block is computed in the background" );
+
+   koinos::rpc::chain::submit_block_request block_req;
+
+   auto duration = std::chrono::system_clock::now().time_since_epoch();
+   block_req.mutable_block()->mutable_header()->set_timestamp( std::chrono::duration_cast< std::chrono::milliseconds >( duration ).count() );
+   block_req.mutable_block()->mutable_header()->set_height( 1 );
+   block_req.mutable_block()->mutable_header()->set_previous( util::converter::as< std::string >( koinos::crypto::multihash::zero( koinos::crypto::multicodec::sha2_256 ) ) );
+   block_req.mutable_block()->mutable_header()->set_previous_state_merkle_root( _controller.get_head_info().head_state_merkle_root() );
+
+   set_block_merkle_roots( *block_req.mutable_block(), koinos::crypto::multicodec::sha2_256 );
+   block_req.mutable_block()->set_id( util::converter::as< std::string >( koinos::crypto::hash( koinos::crypto::multicodec::sha2_256, block_req.block().header() ) ) );
+   sign_block( *block_req.mutable_block(), _block_signing_private_key );
+
+   auto block_resp = _controller.async_submit_block( block_req, 2 ).committed.get();
+   auto state_merkle_root = block_resp.receipt().state_merkle_root();
+
+   BOOST_REQUIRE_EQUAL( state_merkle_root, _controller.get_head_info().head_state_merkle_root() );
+
+   BOOST_TEST_MESSAGE( "Error when a speculatively applied block does not match the deferred merkle root" );
+
+   auto parent_id = block_req.block().id();
+
+   block_req.mutable_block()->mutable_header()->set_height( 2 );
+   block_req.mutable_block()->mutable_header()->set_previous( parent_id );
+   block_req.mutable_block()->mutable_header()->set_previous_state_merkle_root( util::converter::as< std::string >( koinos::crypto::multihash::empty( koinos::crypto::multicodec::sha2_256 ) ) );
+   block_req.mutable_block()->set_id( util::converter::as< std::string >( koinos::crypto::hash( koinos::crypto::multicodec::sha2_256, block_req.block().header() ) ) );
+   sign_block( *block_req.mutable_block(), _block_signing_private_key );
+
+   BOOST_CHECK_THROW( _controller.async_submit_block( block_req, 2 ).committed.get(), chain::state_merkle_mismatch );
+   BOOST_REQUIRE_EQUAL( _controller.get_head_info().head_topology().id(), parent_id );
+
+   BOOST_TEST_MESSAGE( "A speculatively applied block is accepted when the deferred merkle root matches" );
+
+   block_req.mutable_block()->mutable_header()->set_previous_state_merkle_root( state_merkle_root );
+   block_req.mutable_block()->set_id( util::converter::as< std::string >( koinos::crypto::hash( koinos::crypto::multicodec::sha2_256, block_req.block().header() ) ) );
+   sign_block( *block_req.mutable_block(), _block_signing_private_key );
+
+   block_resp = _controller.async_submit_block( block_req, 2 ).committed.get();
+
+   BOOST_REQUIRE_EQUAL( _controller.get_head_info().head_topology().id(), block_req.block().id() );
+   BOOST_REQUIRE_EQUAL( block_resp.receipt().state_merkle_root(), _controller.get_head_info().head_state_merkle_root() );
+
+} KOINOS_CATCH_LOG_AND_RETHROW(info) }
+
+BOOST_AUTO_TEST_CASE( vm_backend_test )
+{ try {
+   BOOST_TEST_MESSAGE( "The controller runs contracts on the named VM backend" );
+
+   BOOST_REQUIRE_NO_THROW( chain::controller( 0, koinos::vm_manager::get_default_vm_backend_name() ) );
+
+   BOOST_TEST_MESSAGE( "Error when the VM backend does not exist" );
+
+   BOOST_REQUIRE_THROW( chain::controller( 0, "unknown" ), chain::unknown_backend_exception );
+
+} KOINOS_CATCH_LOG_AND_RETHROW(info) }
+
 BOOST_AUTO_TEST_SUITE_END()
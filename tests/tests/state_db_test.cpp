@@ -633,6 +633,14 @@ BOOST_AUTO_TEST_CASE( anonymous_node_test )
       BOOST_REQUIRE( ptr );
       BOOST_CHECK_EQUAL( *ptr, "alice" );
 
+      BOOST_TEST_MESSAGE( "Overwriting and recreating object" );
+      std::string short_val = "ali";
+
+      BOOST_CHECK( anon_state->put_object( space, a_key, &short_val ) == -3 );
+      anon_state->remove_object( space, a_key );
+      BOOST_CHECK( !anon_state->get_object( space, a_key ) );
+      BOOST_CHECK( anon_state->put_object( space, a_key, &short_val ) == 3 );
+
       BOOST_TEST_MESSAGE( "Deleting anonymous node" );
    }
 
@@ -666,6 +674,105 @@ BOOST_AUTO_TEST_CASE( anonymous_node_test )
 
 } KOINOS_CATCH_LOG_AND_RETHROW(info) }
 
+BOOST_AUTO_TEST_CASE( multi_get_test )
+{ try {
+   BOOST_TEST_MESSAGE( "Committing objects to the database" );
+   object_space space;
+
+   crypto::multihash state_id = crypto::hash( crypto::multicodec::sha2_256, 1 );
+   auto state_1 = db.create_writable_node( db.get_head()->id(), state_id );
+
+   for ( std::string key : { "a", "b", "c", "d" } )
+      state_1->put_object( space, key, key + "1" );
+
+   db.finalize_node( state_1->id() );
+   db.commit_node( state_1->id() );
+
+   BOOST_TEST_MESSAGE( "Reopening the database to clear the object cache" );
+   db.close();
+   db.open( temp );
+
+   state_id = crypto::hash( crypto::multicodec::sha2_256, 2 );
+   auto state_2 = db.create_writable_node( db.get_head()->id(), state_id );
+   state_2->put_object( space, "b", "b2"s );
+
+   auto anon_state = state_2->create_anonymous_node();
+   anon_state->remove_object( space, "c" );
+   anon_state->put_object( space, "e", "e3"s );
+
+   BOOST_TEST_MESSAGE( "Reading objects from the deltas and the database at once" );
+
+   auto objects = anon_state->get_objects( space, { "a", "b", "c", "d", "e", "f", "a" } );
+   BOOST_REQUIRE_EQUAL( objects.size(), 7 );
+   BOOST_REQUIRE( objects[0] );
+   BOOST_CHECK_EQUAL( *objects[0], "a1" );
+   BOOST_REQUIRE( objects[1] );
+   BOOST_CHECK_EQUAL( *objects[1], "b2" );
+   BOOST_CHECK( !objects[2] );
+   BOOST_REQUIRE( objects[3] );
+   BOOST_CHECK_EQUAL( *objects[3], "d1" );
+   BOOST_REQUIRE( objects[4] );
+   BOOST_CHECK_EQUAL( *objects[4], "e3" );
+   BOOST_CHECK( !objects[5] );
+   BOOST_REQUIRE( objects[6] );
+   BOOST_CHECK_EQUAL( *objects[6], "a1" );
+
+   BOOST_TEST_MESSAGE( "Reading objects through the object cache" );
+
+   objects = db.get_root()->get_objects( space, { "c", "d" } );
+   BOOST_REQUIRE_EQUAL( objects.size(), 2 );
+   BOOST_REQUIRE( objects[0] );
+   BOOST_CHECK_EQUAL( *objects[0], "c1" );
+   BOOST_REQUIRE( objects[1] );
+   BOOST_CHECK_EQUAL( *objects[1], "d1" );
+
+   BOOST_CHECK( db.get_root()->get_objects( space, {} ).empty() );
+
+} KOINOS_CATCH_LOG_AND_RETHROW(info) }
+
+BOOST_AUTO_TEST_CASE( move_semantics_test )
+{ try {
+   BOOST_TEST_MESSAGE( "Moving a value into an anonymous node" );
+   object_space space;
+   std::string a_key = "a";
+
+   crypto::multihash state_id = crypto::hash( crypto::multicodec::sha2_256, 1 );
+   auto state_1 = db.create_writable_node( db.get_head()->id(), state_id );
+
+   std::string a_val( 4096, 'a' );
+   auto buffer = a_val.data();
+
+   {
+      auto anon_state = state_1->create_anonymous_node();
+      BOOST_CHECK( anon_state->put_object( space, a_key, std::move( a_val ) ) == 4096 );
+
+      auto ptr = anon_state->get_object( space, a_key );
+      BOOST_REQUIRE( ptr );
+      BOOST_CHECK( ptr->data() == buffer );
+
+      BOOST_TEST_MESSAGE( "Committing the anonymous node moves the value into its parent" );
+      anon_state->commit();
+
+      ptr = anon_state->get_object( space, a_key );
+      BOOST_REQUIRE( ptr );
+      BOOST_CHECK( ptr->data() == buffer );
+   }
+
+   auto ptr = state_1->get_object( space, a_key );
+   BOOST_REQUIRE( ptr );
+   BOOST_CHECK( ptr->data() == buffer );
+   BOOST_CHECK_EQUAL( *ptr, std::string( 4096, 'a' ) );
+
+   BOOST_TEST_MESSAGE( "Committing the node moves the value into the object cache" );
+   db.finalize_node( state_1->id() );
+   db.commit_node( state_1->id() );
+
+   ptr = db.get_root()->get_object( space, a_key );
+   BOOST_REQUIRE( ptr );
+   BOOST_CHECK( ptr->data() == buffer );
+
+} KOINOS_CATCH_LOG_AND_RETHROW(info) }
+
 BOOST_AUTO_TEST_CASE( merkle_root_test )
 { try {
    auto state_1_id = crypto::hash( crypto::multicodec::sha2_256, 1 );
@@ -771,7 +878,7 @@ BOOST_AUTO_TEST_CASE( rocksdb_backend_test )
    auto itr = backend.begin();
    BOOST_CHECK( itr == backend.end() );
 
-   backend.put( "foo", "bar" );
+   BOOST_CHECK( !backend.put( "foo", "bar" ) );
    itr = backend.begin();
    BOOST_CHECK( itr != backend.end() );
    BOOST_CHECK( *itr == "bar" );
@@ -800,7 +907,7 @@ BOOST_AUTO_TEST_CASE( rocksdb_backend_test )
    BOOST_CHECK( itr != backend.end() );
    BOOST_CHECK( *itr == "bar" );
 
-   backend.put( "foo", "blob" );
+   BOOST_CHECK( backend.put( "foo", "blob" ) == 3u );
    itr = backend.find( "foo" );
    BOOST_CHECK( itr != backend.end() );
    BOOST_CHECK( *itr == "blob" );
@@ -809,7 +916,7 @@ BOOST_AUTO_TEST_CASE( rocksdb_backend_test )
    BOOST_CHECK( itr != backend.end() );
    BOOST_CHECK( *itr == "bob" );
 
-   backend.erase( "foo" );
+   BOOST_CHECK( backend.erase( "foo" ) == 4u );
 
    itr = backend.begin();
    BOOST_CHECK( itr != backend.end() );
@@ -818,9 +925,9 @@ BOOST_AUTO_TEST_CASE( rocksdb_backend_test )
    itr = backend.find( "foo" );
    BOOST_CHECK( itr == backend.end() );
 
-   backend.erase( "foo" );
+   BOOST_CHECK( !backend.erase( "foo" ) );
 
-   backend.erase( "alice" );
+   BOOST_CHECK( backend.erase( "alice" ) == 3u );
    itr = backend.end();
    BOOST_CHECK( itr == backend.end() );
 
@@ -866,6 +973,142 @@ BOOST_AUTO_TEST_CASE( rocksdb_object_cache_test )
    BOOST_CHECK( cache.put( fill_key, fill_val ) );
    BOOST_CHECK( !cache.get( b_key ) );
 
+   // Overwriting 'f' must not leave a stale entry behind to be evicted in its place
+   BOOST_CHECK( cache.put( b_key, b_val ) );
+   BOOST_CHECK( !cache.contains( a_key ) );
+   BOOST_CHECK( cache.contains( fill_key ) );
+   BOOST_CHECK( cache.contains( b_key ) );
+
+   cache.remove( fill_key );
+   BOOST_CHECK( !cache.contains( fill_key ) );
+   BOOST_CHECK( cache.put( a_key, a_val ) );
+   BOOST_CHECK( cache.contains( b_key ) );
+
+   // A try_put never evicts, it only adds objects that are not cached and fit
+   BOOST_CHECK( !cache.try_put( a_key, "eve", cache_size ) );
+   BOOST_CHECK( !cache.try_put( "g", fill_val, cache_size ) );
+   BOOST_CHECK( !cache.contains( "g" ) );
+   BOOST_CHECK( cache.contains( a_key ) );
+   BOOST_CHECK( cache.contains( b_key ) );
+   BOOST_CHECK( cache.try_put( "g", fill_val, cache_size * 2 ) );
+   BOOST_CHECK( cache.contains( a_key ) );
+   BOOST_CHECK( cache.contains( b_key ) );
+
+   auto stats = cache.stats();
+   BOOST_CHECK_EQUAL( stats.hits, 4 );
+   BOOST_CHECK_EQUAL( stats.misses, 3 );
+
+} KOINOS_CATCH_LOG_AND_RETHROW(info) }
+
+BOOST_AUTO_TEST_CASE( rocksdb_prefetch_test )
+{ try {
+   auto temp = std::filesystem::temp_directory_path() / util::random_alphanumeric( 8 );
+   std::filesystem::create_directory( temp );
+
+   {
+      koinos::state_db::backends::rocksdb::rocksdb_backend backend;
+      backend.open( temp );
+      backend.put( "alice", "bob" );
+      backend.put( "charlie", "dave" );
+   }
+
+   koinos::state_db::backends::rocksdb::rocksdb_backend backend;
+   backend.open( temp );
+
+   BOOST_TEST_MESSAGE( "Prefetching objects into the object cache" );
+
+   BOOST_CHECK_EQUAL( backend.prefetch( { "alice", "charlie", "eve" } ), 2 );
+   BOOST_CHECK_EQUAL( backend.prefetch( { "alice", "charlie" } ), 0 );
+
+   auto stats = backend.get_cache_stats();
+   BOOST_CHECK_EQUAL( stats.hits, 0 );
+   BOOST_CHECK_EQUAL( stats.misses, 0 );
+
+   BOOST_REQUIRE( backend.get( "alice" ) );
+   BOOST_CHECK_EQUAL( *backend.get( "charlie" ), "dave" );
+   BOOST_CHECK( !backend.get( "eve" ) );
+
+   stats = backend.get_cache_stats();
+   BOOST_CHECK_EQUAL( stats.hits, 2 );
+   BOOST_CHECK_EQUAL( stats.misses, 1 );
+
+   BOOST_TEST_MESSAGE( "Prefetching nothing while a write batch is open" );
+
+   backend.start_write_batch();
+   backend.put( "eve", "frank" );
+   BOOST_CHECK_EQUAL( backend.prefetch( { "george" } ), 0 );
+   backend.end_write_batch();
+
+   backend.close();
+   std::filesystem::remove_all( temp );
+
+} KOINOS_CATCH_LOG_AND_RETHROW(info) }
+
+BOOST_AUTO_TEST_CASE( rocksdb_iterator_pool_test )
+{ try {
+   auto temp = std::filesystem::temp_directory_path() / util::random_alphanumeric( 8 );
+   std::filesystem::create_directory( temp );
+
+   koinos::state_db::backends::rocksdb::rocksdb_backend backend;
+   backend.open( temp );
+
+   backend.put( "alice", "bob" );
+   backend.put( "charlie", "dave" );
+
+   BOOST_TEST_MESSAGE( "Copying iterators and the end sentinel" );
+
+   auto end = backend.end();
+   BOOST_CHECK( !end.valid() );
+
+   auto end_copy = end;
+   BOOST_CHECK( end_copy == backend.end() );
+
+   --end_copy;
+   BOOST_REQUIRE( end_copy.valid() );
+   BOOST_CHECK_EQUAL( *end_copy, "dave" );
+   BOOST_CHECK( !end.valid() );
+
+   auto itr = backend.begin();
+   auto itr_copy = itr;
+   ++itr;
+   BOOST_CHECK_EQUAL( *itr_copy, "bob" );
+   BOOST_CHECK_EQUAL( *itr, "dave" );
+
+   BOOST_CHECK( backend.find( "eve" ) == backend.end() );
+
+   BOOST_TEST_MESSAGE( "Reusing released iterators after a write" );
+
+   for ( int i = 0; i < 2; i++ )
+   {
+      auto first = backend.begin();
+      BOOST_CHECK_EQUAL( *first, "bob" );
+   }
+
+   backend.put( "aaron", "betty" );
+
+   itr = backend.begin();
+   BOOST_REQUIRE( itr.valid() );
+   BOOST_CHECK_EQUAL( itr.key(), "aaron" );
+   BOOST_CHECK_EQUAL( *itr, "betty" );
+
+   backend.start_write_batch();
+   backend.put( "eve", "frank" );
+   backend.end_write_batch();
+
+   itr = backend.find( "eve" );
+   BOOST_REQUIRE( itr.valid() );
+   BOOST_CHECK_EQUAL( *itr, "frank" );
+
+   backend.erase( "eve" );
+   BOOST_CHECK( backend.find( "eve" ) == backend.end() );
+
+   itr = backend.end();
+   end_copy = backend.end();
+   itr_copy = backend.end();
+
+   backend.close();
+   std::filesystem::remove_all( temp );
+
 } KOINOS_CATCH_LOG_AND_RETHROW(info) }
 
 BOOST_AUTO_TEST_CASE( map_backend_test )
@@ -875,7 +1118,7 @@ BOOST_AUTO_TEST_CASE( map_backend_test )
    auto itr = backend.begin();
    BOOST_CHECK( itr == backend.end() );
 
-   backend.put( "foo", "bar" );
+   BOOST_CHECK( !backend.put( "foo", "bar" ) );
    itr = backend.begin();
    BOOST_CHECK( itr != backend.end() );
    BOOST_CHECK( *itr == "bar" );
@@ -904,7 +1147,7 @@ BOOST_AUTO_TEST_CASE( map_backend_test )
    BOOST_CHECK( itr != backend.end() );
    BOOST_CHECK( *itr == "bar" );
 
-   backend.put( "foo", "blob" );
+   BOOST_CHECK( backend.put( "foo", "blob" ) == 3u );
    itr = backend.find( "foo" );
    BOOST_CHECK( itr != backend.end() );
    BOOST_CHECK( *itr == "blob" );
@@ -913,7 +1156,7 @@ BOOST_AUTO_TEST_CASE( map_backend_test )
    BOOST_CHECK( itr != backend.end() );
    BOOST_CHECK( *itr == "bob" );
 
-   backend.erase( "foo" );
+   BOOST_CHECK( backend.erase( "foo" ) == 4u );
 
    itr = backend.begin();
    BOOST_CHECK( itr != backend.end() );
@@ -922,9 +1165,9 @@ BOOST_AUTO_TEST_CASE( map_backend_test )
    itr = backend.find( "foo" );
    BOOST_CHECK( itr == backend.end() );
 
-   backend.erase( "foo" );
+   BOOST_CHECK( !backend.erase( "foo" ) );
 
-   backend.erase( "alice" );
+   BOOST_CHECK( backend.erase( "alice" ) == 3u );
    itr = backend.end();
    BOOST_CHECK( itr == backend.end() );
 
@@ -1,5 +1,11 @@
 #include <algorithm>
+#include <any>
+#include <chrono>
 #include <filesystem>
+#include <functional>
+#include <limits>
+#include <map>
+#include <thread>
 #include <type_traits>
 #include <vector>
 
@@ -16,6 +22,7 @@
 #include <koinos/chain/constants.hpp>
 #include <koinos/chain/exceptions.hpp>
 #include <koinos/chain/host_api.hpp>
+#include <koinos/chain/prepared_block.hpp>
 #include <koinos/chain/thunk_dispatcher.hpp>
 #include <koinos/chain/session.hpp>
 #include <koinos/chain/state.hpp>
@@ -24,6 +31,8 @@
 #include <koinos/crypto/elliptic.hpp>
 
 #include <koinos/vm_manager/exceptions.hpp>
+#include <koinos/vm_manager/fizzy/fizzy_vm_backend.hpp>
+#include <koinos/vm_manager/fizzy/module_cache.hpp>
 
 #include <koinos/contracts/token/token.pb.h>
 
@@ -248,6 +257,13 @@ void test_thunk( execution_context& ctx, const std::string& s )
    thunk::_log( ctx, "thunk: " + s );
 }
 
+uint64_t benchmark_calls = 0;
+
+void benchmark_thunk( execution_context&, const std::string& )
+{
+   benchmark_calls++;
+}
+
 } // koinos::chain::thunk
 
 BOOST_FIXTURE_TEST_SUITE( thunk_tests, thunk_fixture )
@@ -526,6 +542,89 @@ BOOST_AUTO_TEST_CASE( db_crud )
 
 } KOINOS_CATCH_LOG_AND_RETHROW(info) }
 
+BOOST_AUTO_TEST_CASE( get_object_view_test )
+{ try {
+   BOOST_TEST_MESSAGE( "Test reading an object through the native fast path" );
+
+   chain::object_space test_space;
+   test_space.set_system( true );
+   test_space.set_zone( chain::state::zone::kernel );
+   test_space.set_id( 100 );
+
+   auto object_data = "object1"s;
+   chain::system_call::put_object( ctx, test_space, util::converter::as< std::string >( 1 ), object_data );
+
+   ctx.resource_meter().set_resource_limit_data( chain::system_call::get_resource_limits( ctx ) );
+
+   auto compute_start = ctx.resource_meter().compute_bandwidth_used();
+   auto obj = chain::system_call::get_object( ctx, test_space, util::converter::as< std::string >( 1 ) );
+   auto object_compute = ctx.resource_meter().compute_bandwidth_used() - compute_start;
+
+   std::string buffer;
+
+   compute_start = ctx.resource_meter().compute_bandwidth_used();
+   auto view = chain::system_call::get_object_view( ctx, test_space, util::converter::as< std::string >( 1 ), buffer );
+   auto view_compute = ctx.resource_meter().compute_bandwidth_used() - compute_start;
+
+   BOOST_REQUIRE( view );
+   BOOST_REQUIRE_EQUAL( *view, obj.value() );
+   BOOST_REQUIRE_EQUAL( view_compute, object_compute );
+   BOOST_REQUIRE( view == &buffer );
+
+   BOOST_TEST_MESSAGE( "Test reading an object that does not exist through the native fast path" );
+
+   BOOST_REQUIRE( !chain::system_call::get_object_view( ctx, test_space, util::converter::as< std::string >( 2 ), buffer ) );
+
+   BOOST_TEST_MESSAGE( "Test failure reading a non-system space through the native fast path" );
+
+   test_space.set_system( false );
+   BOOST_REQUIRE_THROW( chain::system_call::get_object_view( ctx, test_space, util::converter::as< std::string >( 1 ), buffer ), chain::insufficient_privileges );
+
+} KOINOS_CATCH_LOG_AND_RETHROW(info) }
+
+BOOST_AUTO_TEST_CASE( get_decoded_object_test )
+{ try {
+   BOOST_TEST_MESSAGE( "Test decoded kernel objects are cached on the context" );
+
+   auto compute_start = ctx.resource_meter().compute_bandwidth_used();
+   chain::system_call::get_object( ctx, chain::state::space::metadata(), chain::state::key::resource_limit_data );
+   auto object_compute = ctx.resource_meter().compute_bandwidth_used() - compute_start;
+
+   compute_start = ctx.resource_meter().compute_bandwidth_used();
+   auto limits = chain::system_call::get_decoded_object< chain::resource_limit_data >( ctx, chain::state::space::metadata(), chain::state::key::resource_limit_data );
+   BOOST_REQUIRE( limits );
+   BOOST_REQUIRE_EQUAL( ctx.resource_meter().compute_bandwidth_used() - compute_start, object_compute );
+
+   compute_start = ctx.resource_meter().compute_bandwidth_used();
+   BOOST_REQUIRE( chain::system_call::get_decoded_object< chain::resource_limit_data >( ctx, chain::state::space::metadata(), chain::state::key::resource_limit_data ) == limits );
+   BOOST_REQUIRE_EQUAL( ctx.resource_meter().compute_bandwidth_used() - compute_start, object_compute );
+
+   BOOST_TEST_MESSAGE( "Test decoded objects are reused in anonymous child nodes" );
+
+   auto block_node = ctx.get_state_node();
+   auto trx_node = block_node->create_anonymous_node();
+   ctx.set_state_node( trx_node );
+   BOOST_REQUIRE( chain::system_call::get_decoded_object< chain::resource_limit_data >( ctx, chain::state::space::metadata(), chain::state::key::resource_limit_data ) == limits );
+
+   BOOST_TEST_MESSAGE( "Test writing a decoded object evicts it" );
+
+   auto new_limits = *limits;
+   new_limits.set_compute_bandwidth_limit( limits->compute_bandwidth_limit() + 1 );
+   chain::system_call::put_object( ctx, chain::state::space::metadata(), chain::state::key::resource_limit_data, util::converter::as< std::string >( new_limits ) );
+
+   auto updated = chain::system_call::get_decoded_object< chain::resource_limit_data >( ctx, chain::state::space::metadata(), chain::state::key::resource_limit_data );
+   BOOST_REQUIRE( updated );
+   BOOST_REQUIRE_EQUAL( updated->compute_bandwidth_limit(), new_limits.compute_bandwidth_limit() );
+
+   BOOST_TEST_MESSAGE( "Test objects read in a discarded anonymous node are not reused by its parent" );
+
+   ctx.set_state_node( block_node );
+   auto reverted = chain::system_call::get_decoded_object< chain::resource_limit_data >( ctx, chain::state::space::metadata(), chain::state::key::resource_limit_data );
+   BOOST_REQUIRE( reverted );
+   BOOST_REQUIRE_EQUAL( reverted->compute_bandwidth_limit(), limits->compute_bandwidth_limit() );
+
+} KOINOS_CATCH_LOG_AND_RETHROW(info) }
+
 BOOST_AUTO_TEST_CASE( contract_tests )
 { try {
    BOOST_TEST_MESSAGE( "Test uploading a contract" );
@@ -567,6 +666,34 @@ BOOST_AUTO_TEST_CASE( contract_tests )
 
    BOOST_REQUIRE_EQUAL( contract_ret, "echo" );
 
+   BOOST_TEST_MESSAGE( "Test a successful exit does not leak to the caller" );
+
+   BOOST_REQUIRE( !ctx.exit_requested() );
+   koinos::chain::system_call::exit_contract( ctx, koinos::chain::exit_code::success );
+   BOOST_REQUIRE( ctx.exit_requested() );
+
+   contract_ret = koinos::chain::system_call::call_contract( ctx, op.contract_id(), 0, "echo" );
+   BOOST_REQUIRE_EQUAL( contract_ret, "echo" );
+   BOOST_REQUIRE( !ctx.exit_requested() );
+
+   BOOST_TEST_MESSAGE( "Test calling a contract repeatedly reuses a reset instance" );
+
+   auto fizzy_backend = std::dynamic_pointer_cast< koinos::vm_manager::fizzy::fizzy_vm_backend >( vm_backend );
+   BOOST_REQUIRE( fizzy_backend );
+   auto pool_start = fizzy_backend->get_instance_pool_stats();
+
+   for ( const auto& arg : { "first echo"s, "echo"s, ""s, "a much longer echo than any call before it"s } )
+   {
+      contract_ret = koinos::chain::system_call::call_contract( ctx, op.contract_id(), 0, arg );
+      BOOST_REQUIRE_EQUAL( contract_ret, arg );
+   }
+
+   // The module keeps its stack pointer in an internal mutable global, which the reset restores
+   auto pool_stats = fizzy_backend->get_instance_pool_stats();
+   BOOST_REQUIRE_EQUAL( pool_stats.reused - pool_start.reused, uint64_t( 4 ) );
+   BOOST_REQUIRE_EQUAL( pool_stats.instantiated, pool_start.instantiated );
+   BOOST_REQUIRE_EQUAL( pool_stats.discarded, pool_start.discarded );
+
 } KOINOS_CATCH_LOG_AND_RETHROW(info) }
 
 BOOST_AUTO_TEST_CASE( override_tests )
@@ -675,6 +802,117 @@ BOOST_AUTO_TEST_CASE( override_tests )
 
 } KOINOS_CATCH_LOG_AND_RETHROW(info) }
 
+BOOST_AUTO_TEST_CASE( execution_context_cache_test )
+{ try {
+   BOOST_TEST_MESSAGE( "Test sharing execution context caches between state nodes" );
+
+   chain::execution_context_cache_registry registry;
+   auto head_cache = registry.get( db.get_head() );
+   BOOST_REQUIRE( head_cache );
+   BOOST_CHECK( registry.get( db.get_head() ) == head_cache );
+   BOOST_CHECK( head_cache->descriptor_pool().FindMessageTypeByName( "koinos.protocol.block" ) != nullptr );
+
+   registry.inherit( ctx.get_state_node(), db.get_head() );
+   BOOST_CHECK( registry.get( ctx.get_state_node() ) == head_cache );
+
+   BOOST_TEST_MESSAGE( "Test writes to cached objects mark the cache dirty" );
+
+   BOOST_REQUIRE( !ctx.cache_dirty() );
+   chain::system_call::put_object( ctx, chain::state::space::metadata(), chain::state::key::head_block_time, util::converter::as< std::string >( uint64_t( 1 ) ) );
+   BOOST_CHECK( !ctx.cache_dirty() );
+
+   protocol::system_call_target target;
+   target.set_thunk_id( std::underlying_type_t< chain::system_call_id >( chain::system_call_id::log ) );
+   chain::system_call::put_object( ctx, chain::state::space::system_call_dispatch(), util::converter::as< std::string >( target.thunk_id() ), util::converter::as< std::string >( target ) );
+   BOOST_CHECK( ctx.cache_dirty() );
+
+   registry.clear();
+   BOOST_CHECK( registry.get( db.get_head() ) != head_cache );
+
+} KOINOS_CATCH_LOG_AND_RETHROW(info) }
+
+BOOST_AUTO_TEST_CASE( module_cache_test )
+{ try {
+   BOOST_TEST_MESSAGE( "Test the module cache is bounded in bytes" );
+
+   auto parse = []( const std::string& bytecode )
+   {
+      auto module = fizzy_parse( reinterpret_cast< const uint8_t* >( bytecode.data() ), bytecode.size(), nullptr );
+      BOOST_REQUIRE( module );
+      return module;
+   };
+
+   const auto& hello = get_hello_wasm();
+   const auto& koin = get_koin_wasm();
+
+   vm_manager::fizzy::module_cache cache( hello.size() + koin.size() - 1 );
+
+   auto hello_module = cache.put_module( "hello", parse( hello ), hello.size(), std::chrono::milliseconds( 1 ) );
+   BOOST_REQUIRE( cache.get_module( "hello" ) == hello_module );
+   BOOST_REQUIRE_EQUAL( cache.size_bytes(), hello.size() );
+
+   // The koin module costs more per byte to parse, so the hello module is evicted
+   auto koin_module = cache.put_module( "koin", parse( koin ), koin.size(), std::chrono::seconds( 1 ) );
+   BOOST_REQUIRE_EQUAL( cache.size(), 1 );
+   BOOST_REQUIRE( !cache.get_module( "hello" ) );
+   BOOST_REQUIRE( cache.get_module( "koin" ) == koin_module );
+
+   BOOST_TEST_MESSAGE( "Test evicted modules remain valid while referenced" );
+
+   uint32_t start_index = 0;
+   BOOST_REQUIRE( fizzy_find_exported_function_index( hello_module.get(), "_start", &start_index ) );
+
+   BOOST_TEST_MESSAGE( "Test a module put by another thread first is shared" );
+
+   BOOST_REQUIRE( cache.put_module( "koin", parse( koin ), koin.size(), std::chrono::seconds( 1 ) ) == koin_module );
+
+   BOOST_TEST_MESSAGE( "Test concurrent access to the module cache" );
+
+   cache.set_max_bytes( hello.size() );
+   BOOST_REQUIRE_EQUAL( cache.size(), 0 );
+
+   std::vector< std::thread > threads;
+   for ( std::size_t i = 0; i < 4; i++ )
+   {
+      threads.emplace_back( [&, i]()
+      {
+         for ( std::size_t j = 0; j < 50; j++ )
+         {
+            auto id = std::to_string( ( i + j ) % 3 );
+            auto module = cache.get_module( id );
+            if ( !module )
+               module = cache.put_module( id, fizzy_parse( reinterpret_cast< const uint8_t* >( hello.data() ), hello.size(), nullptr ), hello.size() / 2, std::chrono::milliseconds( 1 ) );
+
+            uint32_t index = 0;
+            fizzy_find_exported_function_index( module.get(), "_start", &index );
+         }
+      } );
+   }
+
+   for ( auto& t : threads )
+      t.join();
+
+   BOOST_REQUIRE( cache.size_bytes() <= hello.size() );
+
+   BOOST_TEST_MESSAGE( "Test pinned modules are never evicted" );
+
+   vm_manager::fizzy::module_cache pinned_cache( koin.size() );
+
+   auto pinned_module = pinned_cache.put_module( "hello", parse( hello ), hello.size(), std::chrono::milliseconds( 1 ), true );
+   pinned_cache.put_module( "koin", parse( koin ), koin.size(), std::chrono::seconds( 1 ) );
+   BOOST_REQUIRE( pinned_cache.get_module( "hello" ) == pinned_module );
+   BOOST_REQUIRE( !pinned_cache.get_module( "koin" ) );
+
+   BOOST_REQUIRE( !pinned_cache.pin_module( "koin" ) );
+   pinned_cache.set_max_bytes( hello.size() + koin.size() );
+   pinned_cache.put_module( "koin", parse( koin ), koin.size(), std::chrono::seconds( 1 ) );
+   BOOST_REQUIRE( pinned_cache.pin_module( "koin" ) );
+
+   pinned_cache.set_max_bytes( 0 );
+   BOOST_REQUIRE_EQUAL( pinned_cache.size(), 2 );
+
+} KOINOS_CATCH_LOG_AND_RETHROW(info) }
+
 BOOST_AUTO_TEST_CASE( thunk_test )
 { try {
    BOOST_TEST_MESSAGE( "thunk test" );
@@ -698,10 +936,132 @@ BOOST_AUTO_TEST_CASE( thunk_test )
    BOOST_CHECK_EQUAL( ret.size(), 0 );
    BOOST_REQUIRE_EQUAL( "Hello World", ctx.chronicler().logs()[0] );
 
+   BOOST_TEST_MESSAGE( "thunk test with repeated arguments" );
+
+   std::vector< crypto::multihash > leaves;
+   std::vector< std::string > hashes;
+
+   for ( const auto& s : { "foo"s, "bar"s, "baz"s } )
+   {
+      leaves.emplace_back( crypto::hash( crypto::multicodec::sha2_256, s ) );
+      hashes.emplace_back( util::converter::as< std::string >( leaves.back() ) );
+   }
+
+   chain::verify_merkle_root_arguments merkle_args;
+   chain::detail::set_message_field( merkle_args, 1, util::converter::as< std::string >( crypto::merkle_tree( crypto::multicodec::sha2_256, leaves ).root()->hash() ) );
+   chain::detail::set_message_field( merkle_args, 2, hashes );
+   merkle_args.SerializeToString( &arg );
+
+   ret.resize( 32 );
+   ret.resize( host.invoke_thunk( chain::system_call_id::verify_merkle_root, ret.data(), ret.size(), arg.data(), arg.size() ) );
+   BOOST_REQUIRE( util::converter::to< chain::verify_merkle_root_result >( ret ).value() );
+
+   BOOST_TEST_MESSAGE( "Error when the return buffer is too small for the result" );
+
+   BOOST_REQUIRE_THROW( host.invoke_thunk( chain::system_call_id::verify_merkle_root, ret.data(), ret.size() - 1, arg.data(), arg.size() ), koinos::exception );
+
    ctx.push_frame( chain::stack_frame{ .contract_id = "user_contract", .call_privilege = chain::user_mode } );
    BOOST_REQUIRE_THROW( host.invoke_thunk( chain::system_call_id::log, ret.data(), ret.size(), arg.data(), arg.size() ), chain::insufficient_privileges );
 } KOINOS_CATCH_LOG_AND_RETHROW(info) }
 
+BOOST_AUTO_TEST_CASE( thunk_argument_decoding_test )
+{ try {
+   std::string ret;
+
+   auto log_thunk = [&]( const std::string& arg )
+   {
+      host.invoke_thunk( chain::system_call_id::log, ret.data(), ret.size(), arg.data(), arg.size() );
+      return ctx.chronicler().logs().back();
+   };
+
+   chain::log_arguments args;
+   args.set_message( "Hello World" );
+   auto valid = util::converter::as< std::string >( args );
+
+   BOOST_TEST_MESSAGE( "Test a string argument that is not valid UTF-8 is read as the generated parser reads it" );
+
+   std::string arg = "\x0a\x02\xff\xfe"s;
+   chain::log_arguments parsed;
+   BOOST_REQUIRE( !parsed.ParseFromString( arg ) );
+   BOOST_REQUIRE_EQUAL( log_thunk( arg ), parsed.message() );
+
+   arg = "\x0a\x02\xff\xfe"s + valid;
+   BOOST_REQUIRE( !parsed.ParseFromString( arg ) );
+   BOOST_REQUIRE_EQUAL( log_thunk( arg ), parsed.message() );
+
+   BOOST_TEST_MESSAGE( "Test a field with the wrong wire type is skipped" );
+
+   arg = "\x08\x05"s;
+   BOOST_REQUIRE( parsed.ParseFromString( arg ) );
+   BOOST_REQUIRE_EQUAL( log_thunk( arg ), "" );
+
+   arg = valid + "\x0d\x01\x02\x03\x04"s;
+   BOOST_REQUIRE( parsed.ParseFromString( arg ) );
+   BOOST_REQUIRE_EQUAL( log_thunk( arg ), "Hello World" );
+
+   BOOST_TEST_MESSAGE( "Test an unknown field is skipped" );
+
+   arg = "\x12\x03" "abc"s + valid + "\x18\x01"s;
+   BOOST_REQUIRE( parsed.ParseFromString( arg ) );
+   BOOST_REQUIRE_EQUAL( log_thunk( arg ), "Hello World" );
+
+   BOOST_TEST_MESSAGE( "Test a truncated argument is read as the generated parser reads it" );
+
+   arg = valid + "\x12\x05" "abc"s;
+   BOOST_REQUIRE( !parsed.ParseFromString( arg ) );
+   BOOST_REQUIRE_EQUAL( log_thunk( arg ), parsed.message() );
+
+   BOOST_TEST_MESSAGE( "Test registration fails when the thunk arguments do not match the argument fields" );
+
+   auto& dispatcher = const_cast< chain::thunk_dispatcher& >( chain::thunk_dispatcher::instance() );
+   BOOST_REQUIRE_THROW( ( dispatcher.register_thunk< chain::log_arguments, chain::verify_merkle_root_result >( 0, chain::thunk::_verify_merkle_root ) ), chain::field_not_found );
+
+} KOINOS_CATCH_LOG_AND_RETHROW(info) }
+
+BOOST_AUTO_TEST_CASE( thunk_dispatch_benchmark )
+{ try {
+   BOOST_TEST_MESSAGE( "Benchmark thunk dispatch overhead" );
+
+   using thunk_function = std::function< void( chain::execution_context&, const std::string& ) >;
+
+   constexpr uint64_t iterations = 1'000'000;
+   std::string message = "benchmark";
+
+   const_cast< chain::thunk_dispatcher& >( chain::thunk_dispatcher::instance() ).register_thunk< chain::log_arguments, chain::log_result >( 0, chain::thunk::benchmark_thunk );
+
+   // Thunks used to be looked up in a std::map of type erased std::function
+   std::map< uint32_t, std::any > map_dispatch;
+   map_dispatch.insert_or_assign( 0, thunk_function( chain::thunk::benchmark_thunk ) );
+
+   chain::thunk::benchmark_calls = 0;
+
+   auto start = std::chrono::steady_clock::now();
+   for ( uint64_t i = 0; i < iterations; i++ )
+   {
+      auto it = map_dispatch.find( 0 );
+      std::any_cast< thunk_function >( it->second )( ctx, message );
+   }
+   auto map_duration = std::chrono::duration_cast< std::chrono::nanoseconds >( std::chrono::steady_clock::now() - start );
+
+   start = std::chrono::steady_clock::now();
+   for ( uint64_t i = 0; i < iterations; i++ )
+   {
+      chain::thunk_dispatcher::instance().call_thunk< void, const std::string& >( 0, ctx, message );
+   }
+   auto table_duration = std::chrono::duration_cast< std::chrono::nanoseconds >( std::chrono::steady_clock::now() - start );
+
+   BOOST_REQUIRE_EQUAL( chain::thunk::benchmark_calls, 2 * iterations );
+
+   LOG(info) << "std::map dispatch: " << map_duration.count() / double( iterations ) << "ns per call";
+   LOG(info) << "dense table dispatch: " << table_duration.count() / double( iterations ) << "ns per call";
+
+   BOOST_TEST_MESSAGE( "Error when a pass through call does not match the thunk signature" );
+
+   BOOST_REQUIRE_THROW( ( chain::thunk_dispatcher::instance().call_thunk< void, const std::string&, const std::string& >( 0, ctx, message, message ) ), chain::thunk_not_found );
+   BOOST_REQUIRE_THROW( chain::thunk_dispatcher::instance().call_thunk( std::numeric_limits< uint32_t >::max(), ctx, nullptr, 0, nullptr, 0 ), chain::thunk_not_found );
+
+} KOINOS_CATCH_LOG_AND_RETHROW(info) }
+
 BOOST_AUTO_TEST_CASE( system_call_test )
 { try {
    BOOST_TEST_MESSAGE( "system call test" );
@@ -771,6 +1131,76 @@ BOOST_AUTO_TEST_CASE( hash_thunk_test )
 
    BOOST_REQUIRE_THROW( chain::system_call::hash( ctx, 0xDEADBEEF /* unknown code */, blob ), koinos::chain::unknown_hash_code );
 
+   BOOST_TEST_MESSAGE( "Prevalidated digests are returned and charged the same as computed ones" );
+
+   const auto hash_code = static_cast< uint64_t >( crypto::multicodec::sha2_256 );
+   ctx.resource_meter().set_resource_limit_data( chain::system_call::get_resource_limits( ctx ) );
+
+   auto compute_start = ctx.resource_meter().compute_bandwidth_used();
+   chain::system_call::hash( ctx, hash_code, test_string );
+   auto hash_compute = ctx.resource_meter().compute_bandwidth_used() - compute_start;
+
+   auto prevalidation = std::make_shared< chain::prevalidation_cache >();
+   prevalidation->insert_hash( hash_code, test_string, "cached"s );
+   ctx.set_prevalidation_cache( prevalidation );
+
+   compute_start = ctx.resource_meter().compute_bandwidth_used();
+   BOOST_CHECK_EQUAL( chain::system_call::hash( ctx, hash_code, test_string ), "cached"s );
+   BOOST_CHECK_EQUAL( ctx.resource_meter().compute_bandwidth_used() - compute_start, hash_compute );
+
+   thunk_hash = util::converter::to< crypto::multihash >( chain::system_call::hash( ctx, hash_code, blob ) );
+   BOOST_CHECK_EQUAL( thunk_hash, native_hash );
+
+   ctx.set_prevalidation_cache( nullptr );
+
+} KOINOS_CATCH_LOG_AND_RETHROW(info) }
+
+BOOST_AUTO_TEST_CASE( prepared_block_test )
+{ try {
+   BOOST_TEST_MESSAGE( "prepared block test" );
+
+   protocol::block block;
+   block.mutable_header()->set_height( 1 );
+   block.mutable_header()->set_signer( _signing_private_key.get_public_key().to_address_bytes() );
+
+   for ( int i = 0; i < 2; i++ )
+   {
+      auto trx = block.add_transactions();
+      trx->mutable_header()->set_rc_limit( 10 + i );
+      trx->add_operations()->mutable_call_contract()->set_entry_point( i );
+      trx->add_operations()->mutable_call_contract()->set_args( "args"s );
+      trx->add_signatures( "first"s );
+      trx->add_signatures( "second"s );
+   }
+
+   chain::prepared_block prepared( block );
+
+   BOOST_CHECK( prepared.block == &block );
+   BOOST_CHECK_EQUAL( prepared.serialized_header, util::converter::as< std::string >( block.header() ) );
+   BOOST_CHECK_EQUAL( prepared.byte_size, block.ByteSizeLong() );
+   BOOST_REQUIRE_EQUAL( prepared.transactions.size(), block.transactions_size() );
+
+   std::size_t transactions_byte_size = 0;
+
+   for ( int i = 0; i < block.transactions_size(); i++ )
+   {
+      const auto& trx = block.transactions( i );
+      const auto& prepared_trx = prepared.transactions[ i ];
+
+      BOOST_CHECK( prepared_trx.transaction == &trx );
+      BOOST_CHECK_EQUAL( prepared_trx.serialized_header, util::converter::as< std::string >( trx.header() ) );
+      BOOST_CHECK_EQUAL( prepared_trx.concatenated_signatures, "firstsecond"s );
+      BOOST_CHECK_EQUAL( prepared_trx.byte_size, trx.ByteSizeLong() );
+
+      BOOST_REQUIRE_EQUAL( prepared_trx.serialized_operations.size(), trx.operations_size() );
+      for ( int j = 0; j < trx.operations_size(); j++ )
+         BOOST_CHECK_EQUAL( prepared_trx.serialized_operations[ j ], util::converter::as< std::string >( trx.operations( j ) ) );
+
+      transactions_byte_size += trx.ByteSizeLong();
+   }
+
+   BOOST_CHECK_EQUAL( prepared.transactions_byte_size, transactions_byte_size );
+
 } KOINOS_CATCH_LOG_AND_RETHROW(info) }
 
 BOOST_AUTO_TEST_CASE( privileged_calls )
@@ -821,6 +1251,18 @@ BOOST_AUTO_TEST_CASE( stack_tests )
    BOOST_CHECK_EQUAL( call1, ctx.get_caller() );
    BOOST_CHECK_EQUAL( call2, ctx.get_contract_id() );
 
+   std::string args = "args", ret;
+   ctx.push_frame( chain::stack_frame{ .contract_id = call1, .call_args = args, .call_return = &ret } );
+   ctx.push_frame( chain::stack_frame{} );
+   BOOST_CHECK_EQUAL( call2, ctx.get_caller( 1 ) );
+   BOOST_CHECK_EQUAL( call1, ctx.get_caller( 2 ) );
+   BOOST_CHECK_EQUAL( "", ctx.get_caller( 3 ) );
+   BOOST_CHECK( ctx.get_contract_call_args() == args );
+   ctx.set_contract_return( "return" );
+   BOOST_CHECK_EQUAL( ret, "return" );
+   ctx.pop_frame();
+   ctx.pop_frame();
+
    auto last_frame = ctx.pop_frame();
    BOOST_CHECK_EQUAL( call2, last_frame.contract_id );
    BOOST_CHECK_EQUAL( "", ctx.get_caller() );
@@ -1159,6 +1601,65 @@ BOOST_AUTO_TEST_CASE( tick_limit )
 
 } KOINOS_CATCH_LOG_AND_RETHROW(info) }
 
+BOOST_AUTO_TEST_CASE( resource_meter_test )
+{ try {
+   BOOST_TEST_MESSAGE( "Test the session compute budget tracks the session rc" );
+
+   chain::resource_meter meter;
+
+   chain::resource_limit_data rld;
+   rld.set_disk_storage_limit( 1'000 );
+   rld.set_disk_storage_cost( 7 );
+   rld.set_network_bandwidth_limit( 1'000 );
+   rld.set_network_bandwidth_cost( 3 );
+   rld.set_compute_bandwidth_limit( 1'000'000 );
+   rld.set_compute_bandwidth_cost( 11 );
+   meter.set_resource_limit_data( rld );
+
+   auto session = std::make_shared< chain::session >( 100'000 );
+   meter.set_session( session );
+
+   BOOST_REQUIRE_EQUAL( meter.compute_bandwidth_remaining(), 100'000 / 11 );
+
+   meter.use_compute_bandwidth( 123 );
+   BOOST_REQUIRE_EQUAL( session->remaining_rc(), 100'000 - 123 * 11 );
+   BOOST_REQUIRE_EQUAL( meter.compute_bandwidth_remaining(), session->remaining_rc() / 11 );
+
+   meter.use_disk_storage( 5 );
+   meter.use_network_bandwidth( 9 );
+   BOOST_REQUIRE_EQUAL( session->remaining_rc(), 100'000 - 123 * 11 - 5 * 7 - 9 * 3 );
+   BOOST_REQUIRE_EQUAL( meter.compute_bandwidth_remaining(), session->remaining_rc() / 11 );
+
+   meter.use_compute_bandwidth( meter.compute_bandwidth_remaining() );
+   BOOST_REQUIRE_EQUAL( meter.compute_bandwidth_remaining(), 0 );
+   BOOST_REQUIRE_THROW( meter.use_compute_bandwidth( 1 ), chain::insufficient_rc );
+   BOOST_REQUIRE_EQUAL( meter.compute_bandwidth_remaining(), 0 );
+
+   BOOST_TEST_MESSAGE( "Test a released session is no longer charged" );
+
+   auto used = meter.compute_bandwidth_used();
+   session.reset();
+
+   BOOST_REQUIRE_EQUAL( meter.compute_bandwidth_remaining(), 1'000'000 - used );
+   meter.use_compute_bandwidth( 10 );
+   BOOST_REQUIRE_EQUAL( meter.compute_bandwidth_remaining(), 1'000'000 - used - 10 );
+
+   BOOST_TEST_MESSAGE( "Test rc overflow" );
+
+   rld.set_compute_bandwidth_limit( std::numeric_limits< uint64_t >::max() );
+   rld.set_compute_bandwidth_cost( std::numeric_limits< uint64_t >::max() / 2 );
+   meter.set_resource_limit_data( rld );
+
+   session = std::make_shared< chain::session >( std::numeric_limits< uint64_t >::max() );
+   meter.set_session( session );
+
+   BOOST_REQUIRE_EQUAL( meter.compute_bandwidth_remaining(), 2 );
+   BOOST_REQUIRE_THROW( meter.use_compute_bandwidth( 3 ), chain::insufficient_rc );
+   meter.use_compute_bandwidth( 2 );
+   BOOST_REQUIRE_EQUAL( meter.compute_bandwidth_remaining(), 0 );
+
+} KOINOS_CATCH_LOG_AND_RETHROW(info) }
+
 BOOST_AUTO_TEST_CASE( authorize_tests )
 {
    using namespace koinos;
@@ -1673,6 +2174,42 @@ int main()
       std::cout << "   { \"" << key << "\", " << compute << " }," << std::endl;
    }
    std::cout << "};" << std::endl;
+
+   LOG(info) << "Timing compute bandwidth lookup...";
+
+   // Compute costs used to be found by thunk name through the system call id descriptor
+   auto compute_registry = util::converter::to< chain::compute_bandwidth_registry >( chain::system_call::get_object( ctx, chain::state::space::metadata(), chain::state::key::compute_bandwidth_registry ).value() );
+   std::map< std::string, uint64_t > compute_by_name;
+   std::vector< uint32_t > thunk_ids;
+
+   for ( const auto& entry : compute_registry.entries() )
+   {
+      if ( auto enum_value = chain::system_call_id_descriptor()->FindValueByName( entry.name() ); enum_value )
+      {
+         compute_by_name[ entry.name() ] = entry.compute();
+         thunk_ids.push_back( enum_value->number() );
+      }
+   }
+
+   constexpr uint64_t lookup_runs = 10'000;
+   uint64_t name_compute = 0, table_compute = 0;
+
+   auto start = std::chrono::steady_clock::now();
+   for ( uint64_t i = 0; i < lookup_runs; i++ )
+      for ( auto id : thunk_ids )
+         name_compute += compute_by_name.find( chain::system_call_id_descriptor()->FindValueByNumber( id )->name() )->second;
+   auto name_duration = std::chrono::duration_cast< std::chrono::nanoseconds >( std::chrono::steady_clock::now() - start );
+
+   start = std::chrono::steady_clock::now();
+   for ( uint64_t i = 0; i < lookup_runs; i++ )
+      for ( auto id : thunk_ids )
+         table_compute += ctx.get_compute_bandwidth( id );
+   auto table_duration = std::chrono::duration_cast< std::chrono::nanoseconds >( std::chrono::steady_clock::now() - start );
+
+   BOOST_REQUIRE_EQUAL( name_compute, table_compute );
+
+   LOG(info) << "compute lookup by name: " << name_duration.count() / double( lookup_runs * thunk_ids.size() ) << "ns";
+   LOG(info) << "compute lookup by id: " << table_duration.count() / double( lookup_runs * thunk_ids.size() ) << "ns";
 } KOINOS_CATCH_LOG_AND_RETHROW(info) }
 
 BOOST_AUTO_TEST_SUITE_END()